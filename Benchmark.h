@@ -0,0 +1,269 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Benchmark.h
+ *   Cycle-accurate timing of the saber's core primitives. Only include this
+ *   from the sketch when FX_BENCHMARK is defined, it takes over Timer1.
+ *   Host builds (see test/Makefile) time in nanoseconds with the system
+ *   clock instead, against the simulated parts.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <Arduino.h>
+#include "StateMachine.h"
+
+#ifndef __AVR__
+#include <time.h>
+#endif
+
+#define BENCHMARK_REGIONS 2 //Regions besides the primary, as in the saber
+
+#ifdef __AVR__
+//Number of Timer1 overflows since the last CycleBenchmark::Start()
+static volatile uint16_t gBenchmarkOverflows = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+	gBenchmarkOverflows++;
+}
+#endif
+
+/**
+ * Times a block of code in CPU cycles using Timer1 with no prescaler.
+ * Call Start() and Stop() around the code once per iteration, then
+ * Print() to write a row of results to Serial. Rows are comma-separated:
+ *   bench,<name>,<iterations>,<min>,<avg>,<max>
+ * The millis() interrupt still runs while timing, so the average and
+ * maximum include its occasional cost. The minimum does not.
+ *
+ * On the host the times are in nanoseconds. They show the cost of the
+ * logic only, the simulated I/O takes no real time.
+ */
+class CycleBenchmark
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	CycleBenchmark() :
+	mSavedTCCR1A(0),
+	mSavedTCCR1B(0),
+	mSavedTIMSK1(0),
+	mOverhead(0)
+	{
+		Reset();
+	}
+
+	/**
+	 * Take over Timer1, measure the timing overhead and print the header.
+	 */
+	void Begin()
+	{
+#ifdef __AVR__
+		mSavedTCCR1A = TCCR1A;
+		mSavedTCCR1B = TCCR1B;
+		mSavedTIMSK1 = TIMSK1;
+
+		TCCR1A = 0;
+		TCCR1B = _BV(CS10); //Count every CPU cycle
+		TIMSK1 = _BV(TOIE1);
+#endif
+
+		//Measure an empty block so it can be subtracted from every sample
+		for(uint8_t lIter = 0; lIter < 16; lIter++)
+		{
+			Start();
+			Stop();
+		}
+		mOverhead = mMin;
+		Reset();
+
+#ifdef __AVR__
+		Serial.println(F("bench,name,iterations,min_cycles,avg_cycles,max_cycles"));
+#else
+		Serial.println(F("bench,name,iterations,min_ns,avg_ns,max_ns"));
+#endif
+	}
+
+	/**
+	 * Give Timer1 back to its previous owner.
+	 */
+	void End()
+	{
+#ifdef __AVR__
+		TCCR1A = mSavedTCCR1A;
+		TCCR1B = mSavedTCCR1B;
+		TIMSK1 = mSavedTIMSK1;
+#endif
+	}
+
+	/**
+	 * Start timing one iteration.
+	 */
+	inline void Start()
+	{
+#ifdef __AVR__
+		uint8_t lSREG = SREG;
+		cli();
+		gBenchmarkOverflows = 0;
+		TIFR1 = _BV(TOV1);
+		TCNT1 = 0;
+		SREG = lSREG;
+#else
+		clock_gettime(CLOCK_MONOTONIC, &mHostStart);
+#endif
+	}
+
+	/**
+	 * Stop timing one iteration and add it to the statistics.
+	 */
+	inline void Stop()
+	{
+#ifdef __AVR__
+		uint8_t lSREG = SREG;
+		cli();
+		uint16_t lCount = TCNT1;
+		uint32_t lOverflows = gBenchmarkOverflows;
+		//Overflow happened but the interrupt hasn't run yet
+		if((TIFR1 & _BV(TOV1)) && lCount < 0x8000)
+		{
+			lOverflows++;
+		}
+		SREG = lSREG;
+
+		uint32_t lCycles = (lOverflows << 16) + lCount;
+#else
+		struct timespec lHostStop;
+		clock_gettime(CLOCK_MONOTONIC, &lHostStop);
+		uint32_t lCycles = (lHostStop.tv_sec - mHostStart.tv_sec) * 1000000000L +
+						   (lHostStop.tv_nsec - mHostStart.tv_nsec);
+#endif
+		lCycles = (lCycles > mOverhead) ? lCycles - mOverhead : 0;
+
+		mMin = min(mMin, lCycles);
+		mMax = max(mMax, lCycles);
+		mSum += lCycles;
+		mCount++;
+	}
+
+	/**
+	 * Print the statistics collected since the last Print() and reset them.
+	 * Args:
+	 *   apName - Name of the primitive that was timed
+	 */
+	void Print(const __FlashStringHelper* apName)
+	{
+		Serial.print(F("bench,"));
+		Serial.print(apName);
+		Serial.print(',');
+		Serial.print(mCount);
+		Serial.print(',');
+		Serial.print(mCount > 0 ? mMin : 0);
+		Serial.print(',');
+		Serial.print(mCount > 0 ? mSum / mCount : 0);
+		Serial.print(',');
+		Serial.println(mMax);
+		Serial.flush(); //Don't let printing overlap the next measurement
+
+		Reset();
+	}
+
+	/**
+	 * Print the memory usage rows (AVR only):
+	 *   mem,flash_used,<bytes>
+	 *   mem,sram_free,<bytes>
+	 */
+	void PrintMemory()
+	{
+#ifdef __AVR__
+		extern int __data_load_end;
+		extern int __heap_start;
+		extern int* __brkval;
+		int lStackTop;
+
+		Serial.print(F("mem,flash_used,"));
+		Serial.println((unsigned int)&__data_load_end);
+		Serial.print(F("mem,sram_free,"));
+		Serial.println((int)&lStackTop - (__brkval == 0 ? (int)&__heap_start : (int)__brkval));
+		Serial.flush();
+#endif
+	}
+
+private:
+	/**
+	 * Clear the statistics.
+	 */
+	void Reset()
+	{
+		mMin = UINT32_MAX;
+		mMax = 0;
+		mSum = 0;
+		mCount = 0;
+	}
+
+	uint8_t mSavedTCCR1A; //Timer1 settings to restore in End()
+	uint8_t mSavedTCCR1B;
+	uint8_t mSavedTIMSK1;
+
+	uint32_t mOverhead; //Cycles taken by an empty Start()/Stop() pair
+	uint32_t mMin; //Fastest iteration
+	uint32_t mMax; //Slowest iteration
+	uint32_t mSum; //Total of all iterations
+	uint16_t mCount; //Number of iterations
+#ifndef __AVR__
+	struct timespec mHostStart; //When Start() was called
+#endif
+};
+
+/**
+ * State machine with empty bodies, used to time the bookkeeping that
+ * StateMachine::Operate() does on its own. Registers the same number of
+ * regions as the saber so the region overhead is included.
+ */
+class NullStateMachine : public StateMachine
+{
+public:
+	NullStateMachine()
+	{
+		SetRegions(mRegions, BENCHMARK_REGIONS);
+	}
+
+	void Init()
+	{
+		//Do nothing
+	}
+
+	void Body()
+	{
+		//Do nothing
+	}
+
+	void RegionBody(uint8_t /*aRegion*/)
+	{
+		//Do nothing
+	}
+
+private:
+	StateRegion mRegions[BENCHMARK_REGIONS];
+};
+
+#endif /* BENCHMARK_H_ */
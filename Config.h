@@ -0,0 +1,44 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Config.h
+ *   Build options shared by the sketch and the saber sources.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <Arduino.h>
+
+//Uncomment to time the core primitives instead of running the saber.
+//Settings are not saved to EEPROM in this build.
+//#define FX_BENCHMARK
+
+//Debug messages to Serial. Compiled out of benchmark builds so printing
+//doesn't show up in the timings.
+#ifdef FX_BENCHMARK
+#define DEBUG_PRINT(aValue)
+#define DEBUG_PRINTLN(aValue)
+#else
+#define DEBUG_PRINT(aValue) Serial.print(aValue)
+#define DEBUG_PRINTLN(aValue) Serial.println(aValue)
+#endif
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,98 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * EventQueue.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "EventQueue.h"
+
+EventQueue::EventQueue() :
+mHead(0),
+mCount(0)
+{
+	memset(mCoalescedTypes, EVENT_MAX_TYPES, sizeof(mCoalescedTypes));
+	memset(mLastPublished, 0, sizeof(mLastPublished));
+}
+
+bool EventQueue::Publish(uint8_t aType, unsigned int aCoalesceTime)
+{
+	bool lQueued = false;
+	unsigned long lNow = millis();
+	uint8_t lSlot = EVENT_COALESCE_TYPES;
+	bool lSeen = false;
+
+	//Find when this type was last published, or an entry to keep it in
+	if(0 != aCoalesceTime)
+	{
+		for(uint8_t i = 0; i < EVENT_COALESCE_TYPES && !lSeen; i++)
+		{
+			if(aType == mCoalescedTypes[i])
+			{
+				lSlot = i;
+				lSeen = true;
+			}
+			else if(EVENT_MAX_TYPES == mCoalescedTypes[i] && EVENT_COALESCE_TYPES == lSlot)
+			{
+				lSlot = i;
+			}
+		}
+	}
+
+	//Coalesce repeats within the window
+	if(!lSeen || lNow - mLastPublished[lSlot] >= aCoalesceTime)
+	{
+		//Full, drop the oldest
+		if(EVENT_QUEUE_SIZE == mCount)
+		{
+			mHead = (mHead + 1) % EVENT_QUEUE_SIZE;
+			mCount--;
+		}
+
+		Event& lrEvent = mEvents[(mHead + mCount) % EVENT_QUEUE_SIZE];
+		lrEvent.mType = aType;
+		lrEvent.mTime = lNow;
+		mCount++;
+
+		if(EVENT_COALESCE_TYPES != lSlot)
+		{
+			mCoalescedTypes[lSlot] = aType;
+			mLastPublished[lSlot] = lNow;
+		}
+		lQueued = true;
+	}
+
+	return lQueued;
+}
+
+bool EventQueue::Pop(Event& arEvent, uint16_t aMask)
+{
+	bool lFound = false;
+
+	while(!lFound && mCount > 0)
+	{
+		arEvent = mEvents[mHead];
+		mHead = (mHead + 1) % EVENT_QUEUE_SIZE;
+		mCount--;
+
+		lFound = (0 != (aMask & EVENT_BIT(arEvent.mType)));
+	}
+
+	return lFound;
+}
@@ -0,0 +1,104 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * EventQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include <Arduino.h>
+
+#define EVENT_QUEUE_SIZE 8 //Events the queue can hold
+#define EVENT_MAX_TYPES 16 //Event types must be less than this (EVENT_BIT width)
+#define EVENT_COALESCE_TYPES 2 //Event types that can be coalesced at once
+
+//Subscription mask bit for an event type
+#define EVENT_BIT(aType) ((uint16_t)1 << (aType))
+
+/**
+ * An event with the time it was published.
+ */
+struct Event
+{
+	uint8_t mType; //What happened
+	unsigned long mTime; //When it happened (millis)
+};
+
+/**
+ * Fixed-capacity FIFO queue of typed events. Producers publish events as
+ * they detect them and consumers pop only the event types they subscribe
+ * to, in the order they were published. Events a consumer does not
+ * subscribe to are discarded as it reads past them.
+ *
+ * Repeated events of the same type can be coalesced when they are
+ * published, so a burst of identical events only queues the first one.
+ * Publish times are only kept for the first EVENT_COALESCE_TYPES types
+ * published with a coalesce time, others are always queued.
+ * If the queue is full, the oldest event is dropped to make room.
+ */
+class EventQueue
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	EventQueue();
+
+	/**
+	 * Publish an event.
+	 * Args:
+	 *   aType - Type of event (less than EVENT_MAX_TYPES)
+	 *   aCoalesceTime - Drop this event if another of the same type was
+	 *                   published less than this many milliseconds ago
+	 * Returns:
+	 *   TRUE if the event was queued, FALSE if it was coalesced.
+	 */
+	bool Publish(uint8_t aType, unsigned int aCoalesceTime = 0);
+
+	/**
+	 * Remove the oldest subscribed event from the queue. Unsubscribed
+	 * events ahead of it are discarded.
+	 * Args:
+	 *   arEvent - Filled in with the event
+	 *   aMask - Subscribed event types (see EVENT_BIT)
+	 * Returns:
+	 *   TRUE if an event was popped, FALSE if there are none.
+	 */
+	bool Pop(Event& arEvent, uint16_t aMask);
+
+private:
+	//Queued events, oldest at mHead
+	Event mEvents[EVENT_QUEUE_SIZE];
+
+	//Index of the oldest event
+	uint8_t mHead;
+
+	//Number of queued events
+	uint8_t mCount;
+
+	//Types of the coalesced events, EVENT_MAX_TYPES for an unused entry
+	uint8_t mCoalescedTypes[EVENT_COALESCE_TYPES];
+
+	//Time each coalesced event type was last published (millis)
+	unsigned long mLastPublished[EVENT_COALESCE_TYPES];
+};
+
+#endif /* EVENTQUEUE_H_ */
@@ -26,6 +26,13 @@
 #include "SaberStateMachine.h"
 #include "Pins_DIYinoStardust.h"
 #include "Button.h"
+#include "Config.h" //Select a benchmark build here
+
+#ifdef FX_BENCHMARK
+#include "Benchmark.h"
+#define BENCHMARK_ITERATIONS 1000
+void RunBenchmark();
+#endif
 
 //Saber components
 DIYinoSoundPlayer* gpSoundPlayer;
@@ -92,7 +99,7 @@ void setup()
 	gpBlade = new RGBBlade(LED_LS1_PIN, LED_LS2_PIN, LED_LS3_PIN);
 
 	//Motion manager swing tolerances
-	//TODO: Read these from EEPROM, hard-coded for now
+	//These are defaults, the selected profile overrides them (see Profiles.cpp)
 	gToleranceData.mSwingLarge  = 100;
 	gToleranceData.mSwingMedium = 50;
 	gToleranceData.mSwingSmall  = 25;
@@ -115,14 +122,124 @@ void setup()
 	           	   	   	   	   	   	   	   gpMotion,
 										   gpBlade,
 										   gpActButton,
-										   gpAuxButton);
+										   gpAuxButton,
+										   &gToleranceData);
 
 	gpStateMachine->Init();
+
+#ifdef FX_BENCHMARK
+	RunBenchmark();
+#endif
 }
 
 // The loop function is called in an endless loop
 void loop()
 {
+#ifndef FX_BENCHMARK
 	//Run the Saber's primary state machine
 	gpStateMachine->Operate();
+#endif
+}
+
+#ifdef FX_BENCHMARK
+/**
+ * Time each core primitive over many iterations and print the results to
+ * Serial as comma-separated rows (see CycleBenchmark).
+ */
+void RunBenchmark()
+{
+	CycleBenchmark lBench;
+	NullStateMachine lNullMachine;
+	unsigned int lIter;
+
+	//Names of the saber states, in ESaberState order
+	const __FlashStringHelper* lStateNames[] =
+	{
+		F("Body:eeBoot"), F("Body:eeOff"), F("Body:eePoweringUp"),
+		F("Body:eeOnIdle"), F("Body:eeSwing"), F("Body:eePostSwing"),
+		F("Body:eeClash"), F("Body:eePostClash"), F("Body:eeLockup"),
+		F("Body:eeBlaster"), F("Body:eePoweringDown"),
+		F("Body:eeSwitchProfile"), F("Body:eeMenu")
+	};
+
+	lBench.Begin();
+	lBench.PrintMemory();
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		gpActButton->Update();
+		lBench.Stop();
+	}
+	lBench.Print(F("Button::Update"));
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		lNullMachine.Operate();
+		lBench.Stop();
+	}
+	lBench.Print(F("StateMachine::Operate"));
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		gpMotion->Update();
+		lBench.Stop();
+	}
+	lBench.Print(F("MotionManager::Update"));
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		gpBlade->SetChannel(lIter & 0xFF, lIter % 3);
+		lBench.Stop();
+	}
+	lBench.Print(F("Blade::SetChannel"));
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		gpBlade->PerformIO();
+		lBench.Stop();
+	}
+	lBench.Print(F("Blade::PerformIO"));
+
+	for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+	{
+		lBench.Start();
+		gpBlade->ApplyFlicker(1);
+		lBench.Stop();
+	}
+	lBench.Print(F("Blade::ApplyFlicker"));
+
+	//Steady-state cost of each state branch (first sub-state, entry
+	//actions excluded). eeBlaster is timed in its flash, the deflect only
+	//lasts one cycle. Includes the motion update every Body() call makes,
+	//the button updates run in the input region instead.
+	for(int lState = eeBoot; lState <= eeMenu; lState++)
+	{
+		//Run the entry actions outside the timed loop
+		gpStateMachine->ChangeState(lState);
+		gpStateMachine->Operate();
+		gpStateMachine->ChangeState(lState);
+		gpStateMachine->Operate();
+
+		for(lIter = 0; lIter < BENCHMARK_ITERATIONS; lIter++)
+		{
+			gpStateMachine->ChangeState(lState);
+			if(eeBlaster == lState)
+			{
+				gpStateMachine->ChangeSubState(eeBlasterFlash);
+			}
+			lBench.Start();
+			gpStateMachine->Body();
+			lBench.Stop();
+		}
+		lBench.Print(lStateNames[lState]);
+	}
+
+	lBench.End();
+	Serial.println(F("bench,done"));
 }
+#endif
@@ -0,0 +1,200 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * GyroCalibrator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <Wire.h>
+#include "GyroCalibrator.h"
+
+#define MPU6050_RA_XG_OFFS_USRH 0x13
+#define MPU6050_RA_GYRO_CONFIG 0x1B
+#define MPU6050_RA_GYRO_XOUT_H 0x43
+
+#define CAL_WINDOW_SAMPLES 256 //Still samples needed for an estimate
+#define CAL_STILL_RANGE 64 //Max spread of a still window (~2 deg/s, offset units)
+#define CAL_MIN_CORRECTION 1 //Ignore residuals smaller than this (offset units)
+
+GyroCalibrator::GyroCalibrator(uint8_t aAddress) :
+mAddress(aAddress),
+mFullScale(0),
+mReady(false),
+mCount(0)
+{
+	memset(mOffsets, 0, sizeof(mOffsets));
+	Reset();
+}
+
+GyroCalibrator::~GyroCalibrator()
+{
+	// Do nothing
+}
+
+bool GyroCalibrator::Init(const int16_t aOffsets[3])
+{
+	bool lRangeRead = false;
+
+	//Find out which range the motion manager configured
+	Wire.beginTransmission(mAddress);
+	Wire.write(MPU6050_RA_GYRO_CONFIG);
+	if(0 == Wire.endTransmission() &&
+	   Wire.requestFrom(mAddress, (uint8_t)1) >= 1 &&
+	   Wire.available() >= 1)
+	{
+		mFullScale = (Wire.read() >> 3) & 0x03;
+		lRangeRead = true;
+	}
+
+	memcpy(mOffsets, aOffsets, sizeof(mOffsets));
+	mReady = lRangeRead && ApplyOffsets();
+	Reset();
+
+	return mReady;
+}
+
+bool GyroCalibrator::Update()
+{
+	bool lChanged = false;
+	int16_t lRates[3];
+
+	if(mReady && ReadRates(lRates))
+	{
+		bool lStill = true;
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			mSum[lAxis] += lRates[lAxis];
+			mMin[lAxis] = min(mMin[lAxis], lRates[lAxis]);
+			mMax[lAxis] = max(mMax[lAxis], lRates[lAxis]);
+
+			if(ToOffsetUnits((int32_t)mMax[lAxis] - mMin[lAxis]) > CAL_STILL_RANGE)
+			{
+				lStill = false;
+			}
+		}
+		mCount++;
+
+		if(!lStill)
+		{
+			//Saber moved, start over
+			Reset();
+		}
+		else if(mCount >= CAL_WINDOW_SAMPLES)
+		{
+			int16_t lPrevious[3];
+			memcpy(lPrevious, mOffsets, sizeof(mOffsets));
+
+			//Fold the residual bias into the offsets
+			for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+			{
+				int32_t lResidual = ToOffsetUnits(mSum[lAxis]) / mCount;
+				if(abs(lResidual) >= CAL_MIN_CORRECTION)
+				{
+					mOffsets[lAxis] -= lResidual;
+					lChanged = true;
+				}
+			}
+
+			//Keep the offsets in step with the sensor if the write is lost
+			if(lChanged && !ApplyOffsets())
+			{
+				memcpy(mOffsets, lPrevious, sizeof(mOffsets));
+				lChanged = false;
+			}
+			Reset();
+		}
+	}
+
+	return lChanged;
+}
+
+void GyroCalibrator::Reset()
+{
+	for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+	{
+		mSum[lAxis] = 0;
+		mMin[lAxis] = INT16_MAX;
+		mMax[lAxis] = INT16_MIN;
+	}
+	mCount = 0;
+}
+
+bool GyroCalibrator::ReadRates(int16_t aRates[3])
+{
+	bool lSuccess = false;
+
+	Wire.beginTransmission(mAddress);
+	Wire.write(MPU6050_RA_GYRO_XOUT_H);
+	Wire.endTransmission();
+	Wire.requestFrom(mAddress, (uint8_t)6);
+	if(Wire.available() >= 6)
+	{
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			uint8_t lHigh = Wire.read();
+			uint8_t lLow = Wire.read();
+			aRates[lAxis] = (int16_t)((lHigh << 8) | lLow);
+		}
+		lSuccess = true;
+	}
+
+	return lSuccess;
+}
+
+uint16_t GyroCalibrator::ReadSpeed()
+{
+	uint16_t lSpeed = 0;
+	int16_t lRates[3];
+
+	if(ReadRates(lRates))
+	{
+		int32_t lSum = 0;
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			lSum += abs((int32_t)lRates[lAxis]);
+		}
+		lSpeed = (uint16_t)min(ToOffsetUnits(lSum), (int32_t)UINT16_MAX);
+	}
+
+	return lSpeed;
+}
+
+const int16_t* GyroCalibrator::GetOffsets()
+{
+	return mOffsets;
+}
+
+bool GyroCalibrator::ApplyOffsets()
+{
+	Wire.beginTransmission(mAddress);
+	Wire.write(MPU6050_RA_XG_OFFS_USRH);
+	for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+	{
+		Wire.write((uint8_t)(mOffsets[lAxis] >> 8));
+		Wire.write((uint8_t)(mOffsets[lAxis] & 0xFF));
+	}
+
+	return (0 == Wire.endTransmission());
+}
+
+int32_t GyroCalibrator::ToOffsetUnits(int32_t aRaw)
+{
+	//Offset registers are scaled for the 1000 deg/s range (full scale 2)
+	return (aRaw * (1 << mFullScale)) / 4;
+}
@@ -0,0 +1,153 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * GyroCalibrator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef GYROCALIBRATOR_H_
+#define GYROCALIBRATOR_H_
+
+#include <Arduino.h>
+
+#define MPU6050_DEFAULT_ADDRESS 0x68
+
+/**
+ * This class estimates the gyro bias of an MPU6050 while the saber is
+ * still and cancels it using the MPU6050's gyro offset registers. The
+ * offsets are applied inside the sensor, so every sample the motion
+ * manager reads is already compensated at no cost to the main loop.
+ *
+ * Estimation is incremental: each call to Update() takes one sample and
+ * adds it to running statistics. The window restarts whenever the sensor
+ * moves. After a full window of still samples, the mean residual bias is
+ * folded into the offsets.
+ *
+ * Only the gyro is calibrated. The accelerometer reads gravity while still,
+ * so its bias can't be separated from orientation with a single pose.
+ */
+class GyroCalibrator
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *   aAddress - I2C address of the MPU6050
+	 */
+	GyroCalibrator(uint8_t aAddress = MPU6050_DEFAULT_ADDRESS);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~GyroCalibrator();
+
+	/**
+	 * Read the gyro full-scale range and apply the given offsets. Call
+	 * this after the motion manager has initialized the MPU6050 and the
+	 * sensor has had time to wake up. If the sensor doesn't respond,
+	 * calibration stays disabled so a bias that was never cancelled can't
+	 * be folded into the offsets.
+	 * Args:
+	 *   aOffsets - Starting offsets (e.g. loaded from EEPROM)
+	 * Returns:
+	 *   TRUE if the range was read and the offsets applied, FALSE otherwise.
+	 */
+	bool Init(const int16_t aOffsets[3]);
+
+	/**
+	 * Take one sample and update the running bias estimate. Call this
+	 * once per cycle while the saber is off.
+	 * Returns:
+	 *   TRUE if a new estimate changed the offsets, FALSE otherwise.
+	 */
+	bool Update();
+
+	/**
+	 * Discard the current sample window and start a new one.
+	 */
+	void Reset();
+
+	/**
+	 * Read the current (compensated) angular rates.
+	 * Args:
+	 *   aRates - Filled in with the raw X, Y, Z angular rates
+	 * Returns:
+	 *   TRUE if the read succeeded, FALSE otherwise.
+	 */
+	bool ReadRates(int16_t aRates[3]);
+
+	/**
+	 * Read the current angular speed as the sum of the absolute rates of
+	 * all three axes (cheaper than a true magnitude).
+	 * Returns:
+	 *   Angular speed in offset register units (about 32.8 per deg/s),
+	 *   or 0 if the read failed.
+	 */
+	uint16_t ReadSpeed();
+
+	/**
+	 * Get the offsets currently applied to the sensor.
+	 * Returns:
+	 *   X, Y, Z offsets in MPU6050 offset register units (1000 deg/s scale)
+	 */
+	const int16_t* GetOffsets();
+
+protected:
+	/**
+	 * Write the offsets to the MPU6050 gyro offset registers.
+	 * Returns:
+	 *   TRUE if the sensor acknowledged the write, FALSE otherwise.
+	 */
+	bool ApplyOffsets();
+
+	/**
+	 * Convert a raw reading to offset register units.
+	 * Args:
+	 *   aRaw - Raw reading (or sum of readings) at the current range
+	 * Returns:
+	 *   The reading scaled to the 1000 deg/s offset register range.
+	 */
+	int32_t ToOffsetUnits(int32_t aRaw);
+
+private:
+
+	//I2C address of the MPU6050
+	uint8_t mAddress;
+
+	//Gyro full-scale range selection (0 = 250 deg/s ... 3 = 2000 deg/s)
+	uint8_t mFullScale;
+
+	//Set once Init() has reached the sensor
+	bool mReady;
+
+	//Offsets applied to the sensor
+	int16_t mOffsets[3];
+
+	//Running sum of samples in the current window
+	int32_t mSum[3];
+
+	//Smallest and largest sample in the current window
+	int16_t mMin[3];
+	int16_t mMax[3];
+
+	//Number of samples in the current window
+	uint16_t mCount;
+};
+
+#endif /* GYROCALIBRATOR_H_ */
@@ -0,0 +1,36 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Profiles.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "Profiles.h"
+
+/***
+ * Profiles the user can cycle through. These values should be adjusted to
+ * match the fonts on your SD card or SPI Flash and your blade LEDs.
+ */
+const SaberProfile gProfiles[NUM_PROFILES] PROGMEM =
+{
+	//Font Blade color    Flash color      Flicker Swing S/M/L   Clash Volume Lockup length
+	{ 0,   {255, 0, 0},   {255, 255, 0},   1,      25, 50, 100,  10,   15,    2000 },
+	{ 1,   {0, 0, 255},   {255, 255, 255}, 1,      25, 50, 100,  10,   15,    2000 },
+	{ 2,   {0, 255, 0},   {255, 255, 0},   2,      25, 50, 100,  10,   15,    2000 }
+};
@@ -0,0 +1,56 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Profiles.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef PROFILES_H_
+#define PROFILES_H_
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+/**
+ * Everything the user can change by switching profiles. Profiles live in
+ * PROGMEM, so this struct should be kept compact. It is 15 bytes on AVR:
+ * each entry in gProfiles costs 15 bytes of flash and the active copy
+ * held by the state machine costs 15 bytes of SRAM.
+ */
+struct SaberProfile
+{
+	uint8_t mFont; //Sound font on the SD card or SPI Flash
+	uint8_t mBladeColor[3]; //Normal blade color (channels 0, 1, 2)
+	uint8_t mFlashColor[3]; //Clash/effect blade color (channels 0, 1, 2)
+	uint8_t mFlicker; //Blade flicker depth
+	uint8_t mSwingSmall; //Small swing threshold
+	uint8_t mSwingMedium; //Medium swing threshold (also used for twist)
+	uint8_t mSwingLarge; //Large swing threshold
+	uint8_t mClash; //Clash threshold
+	uint8_t mVolume; //Sound volume
+	uint16_t mLockupLength; //Length of the font's lockup sound (ms), it is relaunched at this interval
+};
+
+//Number of entries in gProfiles
+#define NUM_PROFILES 3
+
+//Table of selectable profiles (stored in PROGMEM)
+extern const SaberProfile gProfiles[NUM_PROFILES] PROGMEM;
+
+#endif /* PROFILES_H_ */
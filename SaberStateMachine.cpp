@@ -26,34 +26,96 @@
 
 #define SWITCH_DEBOUCE_TIME 50
 #define POWER_DOWN_SWITCH_TIME 1500
-#define BLADE_FLICKER 1
 #define MIN_SWING_INTERVAL 200
 #define MAX_SWING_INTERVAL 1000
 #define CLASH_PULSE_TIME 100
 #define POST_CLASH_SWING_SUPPRESS_TIME 1000
 #define POWER_UP_TIME 1000
 #define POWER_DOWN_TIME 1000
+#define HUM_RELAUNCH_TIME 30000
+#define CALIBRATION_SAVE_DELTA 4
+#define CLASH_SETTLE_TIME 200
+#define SWING_CLASH_DEFER_TIME 100
+#define LOCKUP_HOLD_TIME 300
+#define LOCKUP_STROBE_MIN_TIME 20
+#define LOCKUP_STROBE_MAX_TIME 60
+#define BLASTER_FLASH_TIME 80
+#define PROFILE_SWITCH_TIMEOUT 3000
+#define BOOT_SOUND_TIME 100
+#define MOTION_RESYNC_TIME 6
+#define MAX_CYCLE_TIME 25
+#define MAX_VOLUME 30
+#define HUM_UPDATE_INTERVAL 50 //At most 20 volume commands per second
+#define HUM_VOLUME_DEADBAND 2 //Ignore smaller volume changes
+#define HUM_SPEED_SHIFT 10 //Angular speed to curve index (~31 deg/s per step)
+#define HUM_RATE_REPORT_TIME 10000
+
+//Hum volume boost by angular speed (index = speed >> HUM_SPEED_SHIFT)
+#define HUM_CURVE_SIZE 32
+static const uint8_t sHumVolumeCurve[HUM_CURVE_SIZE] PROGMEM =
+{
+	0, 0, 0, 1, 1, 2, 3, 4, 5, 6, 6, 7, 8, 8, 9, 9,
+	10, 10, 10, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 12, 12, 12
+};
+
+//Button gestures that work in every powered-on state
+#define POWERED_EVENTS (EVENT_BIT(eeEvtAuxPress) | EVENT_BIT(eeEvtAuxLongPress) | EVENT_BIT(eeEvtActLongPress))
+
+//Events each state subscribes to, in ESaberState order
+static const uint16_t sStateEvents[] PROGMEM =
+{
+	0, //eeBoot
+	EVENT_BIT(eeEvtActTap) | EVENT_BIT(eeEvtAuxTap), //eeOff
+	0, //eePoweringUp
+	POWERED_EVENTS | EVENT_BIT(eeEvtClash) | EVENT_BIT(eeEvtSwingStart), //eeOnIdle
+	0, //eeSwing
+	POWERED_EVENTS | EVENT_BIT(eeEvtClash) | EVENT_BIT(eeEvtSwingEnd) | EVENT_BIT(eeEvtTimeout), //eePostSwing
+	POWERED_EVENTS | EVENT_BIT(eeEvtTimeout), //eeClash
+	POWERED_EVENTS | EVENT_BIT(eeEvtClash) | EVENT_BIT(eeEvtTimeout), //eePostClash
+	POWERED_EVENTS | EVENT_BIT(eeEvtClash) | EVENT_BIT(eeEvtAuxRelease), //eeLockup
+	POWERED_EVENTS | EVENT_BIT(eeEvtClash) | EVENT_BIT(eeEvtTimeout), //eeBlaster
+	0, //eePoweringDown
+	EVENT_BIT(eeEvtActTap) | EVENT_BIT(eeEvtAuxTap) | EVENT_BIT(eeEvtTimeout), //eeSwitchProfile
+	0 //eeMenu
+};
 
 SaberStateMachine::SaberStateMachine(DIYinoSoundPlayer* apSoundPlayer,
 	           	   	  Mpu6050LiteMotionManager* apMotionManger,
 					  IBladeManager* apBlade,
 					  Button* apActButton,
-					  Button* apAuxButton) :
+					  Button* apAuxButton,
+					  MPU6050LiteTolData* apToleranceData) :
 mpSoundPlayer(apSoundPlayer),
 mpMotion(apMotionManger),
 mpBlade(apBlade),
 mpActButton(apActButton),
 mpAuxButton(apAuxButton),
-mLastClashTime(0),
-mLastSwingTime(0)
+mpToleranceData(apToleranceData),
+mProfileIndex(0),
+mLastSwingTime(0),
+mLockupStrobeTime(0),
+mLastCycleTime(0),
+mMaxCycleTime(0),
+mSwinging(false),
+mTimeoutArmed(false),
+mTimeoutState(eeBoot),
+mTimeoutStart(0),
+mTimeoutDuration(0),
+mSentVolume(0),
+mHumUpdateTime(0),
+mVolumeReportTime(0),
+mVolumeUpdates(0)
 {
-	//Do nothing here, handled by initializer list
+	//Operate the sound and input regions alongside the blade
+	SetRegions(mRegions, eeNumRegions, eeInputRegion + 1);
 }
 
 void SaberStateMachine::Init()
 {
 	//Set initial state to the boot-up state
 	mState = eeBoot;
+	mRegions[eeSoundRegion].ChangeState(eeSoundSilent);
+	mRegions[eeInputRegion].ChangeState(eeInputIdle);
 
 	//Initialize components
 	mpBlade->Init();
@@ -62,228 +124,753 @@ void SaberStateMachine::Init()
 	mpActButton->Init();
 	mpAuxButton->Init();
 
+	//Load user settings
+	mSettingsStore.Load(mSettings);
+
 	delay(100); //Give time for the MPU6050 and Sound chip to wake up
-	//TODO: Load the volume level from EEPROM settings
-	mpSoundPlayer->SetVolume(15); //Don't wake the family during late night mad scientist sessions!
+
+	//Restore the gyro calibration now that the MPU6050 is awake
+	if(!mCalibrator.Init(mSettings.mGyroOffset))
+	{
+		DEBUG_PRINTLN("Gyro calibration unavailable.");
+	}
+	//Set the font, volume, colors and thresholds from the selected profile
+	if(mSettings.mSelectedProfile >= NUM_PROFILES)
+	{
+		mSettings.mSelectedProfile = 0;
+	}
+	ApplyProfile(mSettings.mSelectedProfile);
 	delay(100);
 }
 
 void SaberStateMachine::Body()
 {
+	//Every cycle should return quickly, report new worst cases
+	CheckCycleTime();
+
+	//Finish saving settings a byte at a time
+	mSettingsStore.Update();
+
 	//Update motion sensing
 	mpMotion->Update();
 
-	//Detect button presses
-	mpActButton->Update();
-	mpAuxButton->Update();
+	//Turn motion and timer changes into events
+	PublishEvents();
 
-	//Perform state-specific actions
+	int lState = mState;
+
+	//Perform state-specific per-cycle actions
 	switch(mState)
 	{
 	case eeBoot:
-		//Set the current font
-		//TODO: Load this from EEPROM
-		mpSoundPlayer->SetFont(0);
-
 		//Play the boot sound
-		mpSoundPlayer->PlaySound(ESoundTypes::eeBootSnd, 0);
-		delay(100);
-
-		ChangeState(eeOff);
+		if(mIsNewState)
+		{
+			mpSoundPlayer->PlaySound(ESoundTypes::eeBootSnd, 0);
+		}
+		else if(millis() - mStateChangeTime >= BOOT_SOUND_TIME)
+		{
+			ChangeState(eeOff);
+		}
 		break;
 	case eeOff:
-		if(mpActButton->IsPulseEdge() && mpActButton->GetPulseWidth() > SWITCH_DEBOUCE_TIME)
+		//Start a fresh calibration window each time the saber is turned off
+		if(mIsNewState)
 		{
-			ChangeState(eePoweringUp);
+			mCalibrator.Reset();
 		}
 
+		//Saber is most likely lying still, so refine the gyro calibration
+		Calibrate();
 		break;
 	case eePoweringUp:
 		//Do these actions only once upon entering this state
 		if(mIsNewState)
 		{
-			Serial.println("Powering Up"); //Debug
-		}
+			DEBUG_PRINTLN("Powering Up");
 
-		//Play the power up sound
-		mpSoundPlayer->PlaySound(ESoundTypes::eePowerUpSnd, 0);
-		//Turn on the blade
-		//TODO: Load user settings from EEPROM to set color
-		mpBlade->SetChannel(255, 0);
-		mpBlade->SetChannel(0, 1);
-		mpBlade->SetChannel(0, 2);
-
-		//TODO: Use blade ramp time based on power-up sound time, hard-coded for now
-		while(!mpBlade->PowerUp(POWER_UP_TIME - 5))
-		{
-			//Do nothing, just wait for power up complete
+			//Play the power up sound
+			mpSoundPlayer->PlaySound(ESoundTypes::eePowerUpSnd, 0);
+			//Turn on the blade
+			mpBlade->SetChannel(mProfile.mBladeColor[0], 0);
+			mpBlade->SetChannel(mProfile.mBladeColor[1], 1);
+			mpBlade->SetChannel(mProfile.mBladeColor[2], 2);
 		}
 
-		//Re-synchronize the motion manager
-		for(unsigned int lUpd = 0; lUpd <= 5; lUpd++)
+		switch(mSubState)
 		{
-			mpMotion->Update();
-			delay(1);
+		case eePoweringUpRamp:
+			//Advance the blade ramp one step per cycle
+			//TODO: Use blade ramp time based on power-up sound time, hard-coded for now
+			if(mpBlade->PowerUp(POWER_UP_TIME - 5))
+			{
+				ChangeSubState(eePoweringUpResync);
+			}
+			break;
+		case eePoweringUpResync:
+			//Let the motion manager take a few fresh samples before reacting
+			if(millis() - mSubStateChangeTime >= MOTION_RESYNC_TIME)
+			{
+				//Power-up sound flows into the hum
+				mRegions[eeSoundRegion].ChangeState(eeSoundHum);
+				ChangeState(eeOnIdle);
+			}
+			break;
+		default:
+			//Do nothing
+			break;
 		}
-
-		ChangeState(eeOnIdle);
 		break;
 	case eeOnIdle:
 		//Do these actions only once upon entering this state
 		if(mIsNewState)
 		{
-			Serial.println("On."); //Debug
+			DEBUG_PRINTLN("On.");
+			ShowBaseColor();
 
-			//TODO: Load user settings from EEPROM to set color
-			mpBlade->SetChannel(255, 0);
-			mpBlade->SetChannel(0, 1);
-			mpBlade->SetChannel(0, 2);
-			mpBlade->PerformIO();
+			//Swing started while another state had the blade, pick it up now
+			if(mSwinging)
+			{
+				ChangeState(eeSwing);
+			}
 		}
 
-		//User pressed the button, so turn off the saber
-		if(mpActButton->IsHeld() && mpActButton->GetHeldTime() >= POWER_DOWN_SWITCH_TIME)
+		mpBlade->ApplyFlicker(mProfile.mFlicker);
+		break;
+	case eeSwing:
+		mpSoundPlayer->PlayRandomSound(ESoundTypes::eeSwingSnd);
+		ChangeState(eePostSwing);
+		break;
+	case eePostSwing:
+		if(mIsNewState)
 		{
-			//Go to power down state
-			ChangeState(eePoweringDown);
+			//Swing has gone on for a long time after this, so a new swing sound can play
+			//TODO: Repeat swing based on sound timing
+			ArmTimeout(MAX_SWING_INTERVAL);
 		}
-		//Clash event detected
-		else if(this->mpMotion->IsClash())
+
+		//Fire the clash once it won't jam the sound card
+		if(eePostSwingClashPending == mSubState &&
+		   millis() - mStateChangeTime > SWING_CLASH_DEFER_TIME)
 		{
 			ChangeState(eeClash);
 		}
-		//Swing event detected
-		else if(mpMotion->IsSwing() && mpMotion->GetSwingMagnitude() > eeSmall)
+		//Swing ended early, wait out the minimum swing time
+		else if(eePostSwingEnded == mSubState &&
+				millis() - mStateChangeTime >= MIN_SWING_INTERVAL)
 		{
-			ChangeState(eeSwing);
+			ChangeState(eeOnIdle);
 		}
-		//Re-launch hum after 30 seconds
-		//TODO: Re-launch based on sound timings
-		else if(millis() - mStateChangeTime >= 30000)
+		break;
+	case eeClash:
+		//Do these actions only once upon entering this state
+		if(mIsNewState)
 		{
-			Serial.println("Hum re-launch.");
-			mpSoundPlayer->PlaySound(ESoundTypes::eeHumSnd, 0);
-			mStateChangeTime = millis(); //Reset the state change time so we don't keep repeating
+			//Play a clash sound
+			mpSoundPlayer->PlayRandomSound(ESoundTypes::eeClashSnd);
+
+			//Set blade to the flash color
+			ShowFlashColor();
+
+			ArmTimeout(CLASH_PULSE_TIME);
 		}
-		else
+		break;
+	case eePostClash:
+		//TODO: Use sound timings to decide when the clash sound is done playing
+		if(mIsNewState)
 		{
-			//TODO: Use settings from EEPROM
-			mpBlade->ApplyFlicker(BLADE_FLICKER);
+			ArmTimeout(POST_CLASH_SWING_SUPPRESS_TIME);
 		}
 		break;
-	case eeSwing:
-		mpSoundPlayer->PlayRandomSound(ESoundTypes::eeSwingSnd);
-		ChangeState(eePostSwing);
-		break;
-	case eePostSwing:
-		//User wants to power down the saber
-		if(mpActButton->IsHeld() && mpActButton->GetHeldTime() >= POWER_DOWN_SWITCH_TIME)
+	case eeLockup:
+		//Lockup lasts as long as the auxiliary button is held
+		if(mIsNewState)
 		{
-			ChangeState(eePoweringDown);
+			DEBUG_PRINTLN("Lockup.");
+			mpSoundPlayer->PlaySound(ESoundTypes::eeLockupSnd, 0);
+			mRegions[eeSoundRegion].ChangeState(eeSoundLockup);
 		}
-		//A clash happened
-		else if(mpMotion->IsClash())
+
+		switch(mSubState)
 		{
-			//Don't jam the sound card with too many requests
-			while(millis() - mStateChangeTime <= 100)
+		case eeLockupFlare:
+			if(mIsNewSubState)
 			{
-				delay(1);
-				mpMotion->Update();
+				ShowFlashColor();
 			}
-			ChangeState(eeClash);
+			else if(millis() - mSubStateChangeTime > CLASH_PULSE_TIME)
+			{
+				ChangeSubState(eeLockupStrobeBase);
+			}
+			break;
+		case eeLockupStrobeBase:
+		case eeLockupStrobeFlash:
+			//Flip between the base and flash colors at a jittery rate
+			if(mIsNewSubState)
+			{
+				if(eeLockupStrobeFlash == mSubState)
+				{
+					ShowFlashColor();
+				}
+				else
+				{
+					ShowBaseColor();
+				}
+				mLockupStrobeTime = random(LOCKUP_STROBE_MIN_TIME, LOCKUP_STROBE_MAX_TIME);
+			}
+			else if(millis() - mSubStateChangeTime >= mLockupStrobeTime)
+			{
+				ChangeSubState(eeLockupStrobeFlash == mSubState ? eeLockupStrobeBase : eeLockupStrobeFlash);
+			}
+			break;
+		default:
+			//Do nothing
+			break;
 		}
-		//Swing is over
-		else if(!mpMotion->IsSwing() && millis() - mStateChangeTime >= MIN_SWING_INTERVAL)
+		break;
+	case eeBlaster:
+		if(eeBlasterDeflect == mSubState)
 		{
-			ChangeState(eeOnIdle);
+			//Respond in the same cycle the deflect was requested
+			mpSoundPlayer->PlayRandomSound(ESoundTypes::eeBlasterSnd);
+			ShowFlashColor();
+			ArmTimeout(BLASTER_FLASH_TIME);
+			ChangeSubState(eeBlasterFlash);
+		}
+		break;
+	case eePoweringDown:
+		if(mIsNewState)
+		{
+			DEBUG_PRINTLN("Powering down");
+			mRegions[eeSoundRegion].ChangeState(eeSoundSilent);
+
+			//Play power down sound
+			mpSoundPlayer->PlaySound(ESoundTypes::eePowerDownSnd, 0);
 		}
-		//Swing has gone on for a long time, exit this state so a new swing sound can play
-		//TODO: Repeat swing based on sound timing
-		else if(millis() - mStateChangeTime > MAX_SWING_INTERVAL)
+
+		switch(mSubState)
 		{
-			ChangeState(eeOnIdle);
+		case eePoweringDownRamp:
+			//Turn off the blade one step per cycle
+			//TODO: Use sound timings to decide how long power-down should take
+			if(mpBlade->PowerDown(POWER_DOWN_TIME))
+			{
+				ChangeSubState(eePoweringDownRelease);
+			}
+			break;
+		case eePoweringDownRelease:
+			//Wait for user to let off the button so the release doesn't power up again
+			if(!mpActButton->IsHeld() && !mpActButton->IsPulseEdge())
+			{
+				ChangeState(eeOff);
+			}
+			break;
+		default:
+			//Do nothing
+			break;
 		}
 		break;
-	case eeClash:
-		//Do these actions only once upon entering this state
+	case eeSwitchProfile:
+		//Entering the state moves to the next profile
 		if(mIsNewState)
 		{
-			//Capture the time of the clash event
-			mLastClashTime = millis();
+			NextProfile();
+		}
+		break;
+	case eeMenu:
+		//TBD
+		break;
+	default:
+		//Do nothing
+		break;
+	}
 
-			//Play a clash sound
-			mpSoundPlayer->PlayRandomSound(ESoundTypes::eeClashSnd);
+	//Deliver the events this state subscribes to, in the order they were
+	//published. Stop at a state change so the new state runs its entry
+	//actions before it sees any events.
+	Event lEvent;
+	uint16_t lMask = pgm_read_word(&sStateEvents[mState]);
+	while(lState == mState && mEvents.Pop(lEvent, lMask))
+	{
+		HandleEvent(lEvent);
+	}
+}
 
-			//Set blade to the flash color
-			//TODO: Load flash color settings from EEPROM
-			mpBlade->SetChannel(255, 0);
-			mpBlade->SetChannel(255, 1);
-			mpBlade->SetChannel(0, 2);
-			mpBlade->PerformIO();
+void SaberStateMachine::HandleEvent(const Event& arEvent)
+{
+	switch(arEvent.mType)
+	{
+	//Gestures that work the same way in every powered-on state
+	case eeEvtAuxPress:
+		//Deflect as soon as the button goes down
+		if(eeBlaster == mState)
+		{
+			ChangeSubState(eeBlasterDeflect);
 		}
+		else
+		{
+			ChangeState(eeBlaster);
+		}
+		break;
+	case eeEvtAuxLongPress:
+		//Button is still down after the deflect, so this is a lockup
+		if(eeLockup != mState)
+		{
+			ChangeState(eeLockup);
+		}
+		break;
+	case eeEvtActLongPress:
+		//User is holding the button, so turn off the saber
+		ChangeState(eePoweringDown);
+		break;
+	default:
+		HandleStateEvent(arEvent);
+		break;
+	}
+}
 
-		if(millis() - mStateChangeTime > CLASH_PULSE_TIME)
+void SaberStateMachine::HandleStateEvent(const Event& arEvent)
+{
+	switch(mState)
+	{
+	case eeOff:
+		if(eeEvtActTap == arEvent.mType)
+		{
+			ChangeState(eePoweringUp);
+		}
+		//Auxiliary button scrolls through the profiles
+		else if(eeEvtAuxTap == arEvent.mType)
+		{
+			ChangeState(eeSwitchProfile);
+		}
+		break;
+	case eeOnIdle:
+		if(eeEvtClash == arEvent.mType)
+		{
+			ChangeState(eeClash);
+		}
+		else if(eeEvtSwingStart == arEvent.mType)
+		{
+			ChangeState(eeSwing);
+		}
+		break;
+	case eePostSwing:
+		if(eeEvtClash == arEvent.mType)
+		{
+			//Don't jam the sound card with too many requests, defer the
+			//clash if it came right after the swing sound
+			if(millis() - mStateChangeTime <= SWING_CLASH_DEFER_TIME)
+			{
+				ChangeSubState(eePostSwingClashPending);
+			}
+			else
+			{
+				ChangeState(eeClash);
+			}
+		}
+		//A pending clash takes priority over the end of the swing
+		else if(eePostSwingClashPending == mSubState)
+		{
+			//Do nothing
+		}
+		else if(eeEvtSwingEnd == arEvent.mType)
+		{
+			if(millis() - mStateChangeTime >= MIN_SWING_INTERVAL)
+			{
+				ChangeState(eeOnIdle);
+			}
+			else
+			{
+				ChangeSubState(eePostSwingEnded);
+			}
+		}
+		else if(eeEvtTimeout == arEvent.mType)
+		{
+			//Still swinging, play another swing sound
+			ChangeState(mSwinging ? eeSwing : eeOnIdle);
+		}
+		break;
+	case eeClash:
+		if(eeEvtTimeout == arEvent.mType)
 		{
 			//Set blade back to the normal color
-			//TODO: Load color from EEPROM
-			mpBlade->SetChannel(255, 0);
-			mpBlade->SetChannel(0, 1);
-			mpBlade->SetChannel(0, 2);
-			mpBlade->PerformIO();
+			ShowBaseColor();
 
 			ChangeState(eePostClash);
 		}
 		break;
 	case eePostClash:
-		if(mpMotion->IsClash() && millis() - mLastClashTime > 200)
+		if(eeEvtClash == arEvent.mType)
 		{
-			//Respond to new clash events, but not at a rate faster than once per 200ms
+			//Clash events are coalesced so they don't arrive faster than once per 200ms
 			//This allows for clash to settle and avoids jamming the sound card
-			Serial.print("Clash repeat. State time delta ="); //Debug
-			Serial.println(millis() - mStateChangeTime);      //Debug
+			DEBUG_PRINT("Clash repeat. State time delta =");
+			DEBUG_PRINTLN(arEvent.mTime - mStateChangeTime);
 			ChangeState(eeClash);
 		}
-		//TODO: Use sound timings to decide when the clash sound is done playing
-		else if(millis() - mStateChangeTime >= POST_CLASH_SWING_SUPPRESS_TIME)
+		else if(eeEvtTimeout == arEvent.mType)
 		{
 			ChangeState(eeOnIdle);
 		}
 		break;
 	case eeLockup:
-		//TBD
+		//Blade keeps reacting to impacts during lockup
+		if(eeEvtClash == arEvent.mType)
+		{
+			mpSoundPlayer->PlaySound(ESoundTypes::eeLockupSnd, 0);
+			mRegions[eeSoundRegion].ChangeState(eeSoundLockup);
+			ChangeSubState(eeLockupFlare);
+		}
+		else if(eeEvtAuxRelease == arEvent.mType)
+		{
+			ChangeState(eeOnIdle);
+		}
 		break;
 	case eeBlaster:
-		//TBD
+		//Clash interrupts the deflect flash
+		if(eeEvtClash == arEvent.mType)
+		{
+			ChangeState(eeClash);
+		}
+		else if(eeEvtTimeout == arEvent.mType)
+		{
+			ChangeState(eeOnIdle);
+		}
 		break;
-	case eePoweringDown:
-		Serial.println("Powering down"); //Debug
+	case eeSwitchProfile:
+		//Each press of the auxiliary button moves to the next profile
+		if(eeEvtAuxTap == arEvent.mType)
+		{
+			NextProfile();
+		}
+		//Activation button or a pause confirms the selection
+		else if(eeEvtActTap == arEvent.mType || eeEvtTimeout == arEvent.mType)
+		{
+			//Only touch EEPROM once the user has settled on a profile
+			if(mSettings.mSelectedProfile != mProfileIndex)
+			{
+				mSettings.mSelectedProfile = mProfileIndex;
+				mSettingsStore.Save(mSettings);
+			}
+			ChangeState(eeOff);
+		}
+		break;
+	default:
+		//Do nothing
+		break;
+	}
+}
 
-		//Play power down sound
-		mpSoundPlayer->PlaySound(ESoundTypes::eePowerDownSnd, 0);
+void SaberStateMachine::PublishEvents()
+{
+	//Clash flags repeat while the blade settles, only queue the first one
+	if(mpMotion->IsClash())
+	{
+		mEvents.Publish(eeEvtClash, CLASH_SETTLE_TIME);
+	}
+
+	//Swing start and end edges
+	if(!mSwinging && mpMotion->IsSwing() && mpMotion->GetSwingMagnitude() > eeSmall)
+	{
+		mSwinging = true;
+		mEvents.Publish(eeEvtSwingStart);
+	}
+	else if(mSwinging && !mpMotion->IsSwing())
+	{
+		mSwinging = false;
+		mEvents.Publish(eeEvtSwingEnd);
+	}
 
-		//Turn off the blade
-		//TODO: Use sound timings to decide how long power-down should take
-		while(!mpBlade->PowerDown(POWER_DOWN_TIME))
+	//Timeouts only belong to the state that armed them
+	if(mTimeoutArmed)
+	{
+		if(mTimeoutState != mState)
+		{
+			mTimeoutArmed = false;
+		}
+		else if(millis() - mTimeoutStart >= mTimeoutDuration)
 		{
-			//Do nothing, just wait for power down
+			mTimeoutArmed = false;
+			mEvents.Publish(eeEvtTimeout);
 		}
+	}
+}
+
+void SaberStateMachine::ArmTimeout(unsigned int aDuration)
+{
+	mTimeoutArmed = true;
+	mTimeoutState = mState;
+	mTimeoutStart = millis();
+	mTimeoutDuration = aDuration;
+}
+
+void SaberStateMachine::NextProfile()
+{
+	ApplyProfile((mProfileIndex + 1) % NUM_PROFILES);
 
-		//Wait for user to let off the button
-		while(mpActButton->IsHeld() || mpActButton->IsPulseEdge())
+	//Let the user hear which font is selected
+	mpSoundPlayer->PlaySound(ESoundTypes::eeFontIdSnd, 0);
+	ArmTimeout(PROFILE_SWITCH_TIMEOUT);
+}
+
+void SaberStateMachine::RegionBody(uint8_t aRegion)
+{
+	switch(aRegion)
+	{
+	case eeInputRegion:
+		InputBody(mRegions[eeInputRegion]);
+		break;
+	case eeSoundRegion:
+		SoundBody(mRegions[eeSoundRegion]);
+		break;
+	default:
+		//Do nothing
+		break;
+	}
+}
+
+void SaberStateMachine::SoundBody(StateRegion& arRegion)
+{
+	switch(arRegion.GetState())
+	{
+	case eeSoundSilent:
+		//Nothing to keep going
+		if(arRegion.IsNewState())
 		{
-			mpActButton->Update();
+			SetVolume(mProfile.mVolume);
 		}
-		ChangeState(eeOff);
 		break;
-	case eeSwitchProfile:
-		//TBD
+	case eeSoundHum:
+		//Re-launch hum every 30 seconds, swings and clashes don't reset this
+		//TODO: Re-launch based on sound timings
+		if(arRegion.GetStateTime() >= HUM_RELAUNCH_TIME)
+		{
+			DEBUG_PRINTLN("Hum re-launch.");
+			mpSoundPlayer->PlaySound(ESoundTypes::eeHumSnd, 0);
+			arRegion.ChangeState(eeSoundHum); //Restart the timer so we don't keep repeating
+		}
+		else
+		{
+			ModulateHum();
+		}
 		break;
-	case eeMenu:
-		//TBD
+	case eeSoundLockup:
+		if(arRegion.IsNewState())
+		{
+			SetVolume(mProfile.mVolume);
+		}
+
+		//Lockup is over, go back to the hum
+		if(eeLockup != mState)
+		{
+			if(IsPoweredOn())
+			{
+				mpSoundPlayer->PlaySound(ESoundTypes::eeHumSnd, 0);
+				arRegion.ChangeState(eeSoundHum);
+			}
+			else
+			{
+				arRegion.ChangeState(eeSoundSilent);
+			}
+		}
+		//Keep the lockup sound looping, relaunch it as the clip ends
+		else if(arRegion.GetStateTime() >= mProfile.mLockupLength)
+		{
+			mpSoundPlayer->PlaySound(ESoundTypes::eeLockupSnd, 0);
+			arRegion.ChangeState(eeSoundLockup);
+		}
 		break;
 	default:
 		//Do nothing
 		break;
 	}
-	//TODO: Fill this in
+}
+
+void SaberStateMachine::InputBody(StateRegion& arRegion)
+{
+	//Detect button presses
+	mpActButton->Update();
+	mpAuxButton->Update();
+
+	switch(arRegion.GetState())
+	{
+	case eeInputIdle:
+		if(mpActButton->IsHeld())
+		{
+			arRegion.ChangeState(eeInputActHeld);
+		}
+		else if(mpAuxButton->IsHeld())
+		{
+			//A press right after a release is contact bounce, not a new press
+			if(arRegion.GetStateTime() >= SWITCH_DEBOUCE_TIME)
+			{
+				mEvents.Publish(eeEvtAuxPress);
+			}
+			arRegion.ChangeState(eeInputAuxHeld);
+		}
+		break;
+	case eeInputActHeld:
+		if(mpActButton->IsPulseEdge())
+		{
+			//Button was released, it was a tap unless it was a long press
+			if(eeInputLongPressed != arRegion.GetSubState() &&
+			   mpActButton->GetPulseWidth() > SWITCH_DEBOUCE_TIME)
+			{
+				mEvents.Publish(eeEvtActTap);
+			}
+			arRegion.ChangeState(eeInputIdle);
+		}
+		else if(eeInputLongPressed != arRegion.GetSubState() &&
+				mpActButton->GetHeldTime() >= POWER_DOWN_SWITCH_TIME)
+		{
+			mEvents.Publish(eeEvtActLongPress);
+			arRegion.ChangeSubState(eeInputLongPressed);
+		}
+		break;
+	case eeInputAuxHeld:
+		if(mpAuxButton->IsPulseEdge())
+		{
+			//Button was released, it was a tap unless it was a long press
+			mEvents.Publish(eeEvtAuxRelease);
+			if(eeInputLongPressed != arRegion.GetSubState() &&
+			   mpAuxButton->GetPulseWidth() > SWITCH_DEBOUCE_TIME)
+			{
+				mEvents.Publish(eeEvtAuxTap);
+			}
+			arRegion.ChangeState(eeInputIdle);
+		}
+		else if(eeInputLongPressed != arRegion.GetSubState() &&
+				mpAuxButton->GetHeldTime() >= LOCKUP_HOLD_TIME)
+		{
+			mEvents.Publish(eeEvtAuxLongPress);
+			arRegion.ChangeSubState(eeInputLongPressed);
+		}
+		break;
+	default:
+		//Do nothing
+		break;
+	}
+}
+
+bool SaberStateMachine::IsPoweredOn()
+{
+	return (mState >= eeOnIdle && mState <= eeBlaster);
+}
+
+void SaberStateMachine::Calibrate()
+{
+	if(mCalibrator.Update())
+	{
+		const int16_t* lpOffsets = mCalibrator.GetOffsets();
+		bool lSave = false;
+
+		//Only write to EEPROM for significant changes to limit wear
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			if(abs(lpOffsets[lAxis] - mSettings.mGyroOffset[lAxis]) >= CALIBRATION_SAVE_DELTA)
+			{
+				lSave = true;
+			}
+		}
+
+		if(lSave)
+		{
+			DEBUG_PRINTLN("Gyro calibration saved.");
+			memcpy(mSettings.mGyroOffset, lpOffsets, sizeof(mSettings.mGyroOffset));
+			mSettingsStore.Save(mSettings);
+		}
+	}
+}
+
+void SaberStateMachine::ShowBaseColor()
+{
+	mpBlade->SetChannel(mProfile.mBladeColor[0], 0);
+	mpBlade->SetChannel(mProfile.mBladeColor[1], 1);
+	mpBlade->SetChannel(mProfile.mBladeColor[2], 2);
+	mpBlade->PerformIO();
+}
+
+void SaberStateMachine::ShowFlashColor()
+{
+	mpBlade->SetChannel(mProfile.mFlashColor[0], 0);
+	mpBlade->SetChannel(mProfile.mFlashColor[1], 1);
+	mpBlade->SetChannel(mProfile.mFlashColor[2], 2);
+	mpBlade->PerformIO();
+}
+
+void SaberStateMachine::ApplyProfile(uint8_t aIndex)
+{
+	mProfileIndex = aIndex;
+	memcpy_P(&mProfile, &gProfiles[aIndex], sizeof(SaberProfile));
+
+	//The motion manager reads its thresholds through this pointer
+	mpToleranceData->mSwingSmall = mProfile.mSwingSmall;
+	mpToleranceData->mSwingMedium = mProfile.mSwingMedium;
+	mpToleranceData->mSwingLarge = mProfile.mSwingLarge;
+	mpToleranceData->mClash = mProfile.mClash;
+	mpToleranceData->mTwist = mProfile.mSwingMedium;
+
+	mpSoundPlayer->SetFont(mProfile.mFont);
+	SetVolume(mProfile.mVolume);
+}
+
+void SaberStateMachine::ModulateHum()
+{
+	unsigned long lNow = millis();
+
+	//Rate-limit so the serial link to the sound module stays free
+	if(lNow - mHumUpdateTime >= HUM_UPDATE_INTERVAL)
+	{
+		mHumUpdateTime = lNow;
+
+		//Read once, min() is a macro and would evaluate it twice
+		uint16_t lSpeed = mCalibrator.ReadSpeed() >> HUM_SPEED_SHIFT;
+		uint8_t lIndex = min(lSpeed, HUM_CURVE_SIZE - 1);
+		uint8_t lVolume = min(mProfile.mVolume + pgm_read_byte(&sHumVolumeCurve[lIndex]), MAX_VOLUME);
+
+		//Only send meaningful changes, but always settle back to the base volume
+		if(abs(lVolume - mSentVolume) >= HUM_VOLUME_DEADBAND ||
+		   (lVolume == mProfile.mVolume && lVolume != mSentVolume))
+		{
+			SetVolume(lVolume);
+		}
+	}
+
+	//Report how busy the link is
+	if(lNow - mVolumeReportTime >= HUM_RATE_REPORT_TIME)
+	{
+		DEBUG_PRINT("Volume updates per 10s: ");
+		DEBUG_PRINTLN(mVolumeUpdates);
+		mVolumeUpdates = 0;
+		mVolumeReportTime = lNow;
+	}
+}
+
+void SaberStateMachine::SetVolume(uint8_t aVolume)
+{
+	if(aVolume != mSentVolume)
+	{
+		mpSoundPlayer->SetVolume(aVolume);
+		mSentVolume = aVolume;
+		mVolumeUpdates++;
+	}
+}
+
+void SaberStateMachine::CheckCycleTime()
+{
+	unsigned long lNow = millis();
+
+	if(0 != mLastCycleTime && lNow - mLastCycleTime > mMaxCycleTime)
+	{
+		mMaxCycleTime = lNow - mLastCycleTime;
+		if(mMaxCycleTime > MAX_CYCLE_TIME)
+		{
+			DEBUG_PRINT("Slow cycle (ms) in state ");
+			DEBUG_PRINT(mState);
+			DEBUG_PRINT(": ");
+			DEBUG_PRINTLN(mMaxCycleTime);
+		}
+	}
+
+	mLastCycleTime = lNow;
 }
@@ -25,8 +25,14 @@
 #define SABERSTATEMACHINE_H_
 
 #include <USaber.h>
+#include "Config.h"
 #include "StateMachine.h"
 #include "Button.h"
+#include "Settings.h"
+#include "SettingsStore.h"
+#include "GyroCalibrator.h"
+#include "Profiles.h"
+#include "EventQueue.h"
 
 /**
  * Enumeration of all possible saber states.
@@ -48,9 +54,123 @@ enum ESaberState
 	eeMenu
 };
 
+/**
+ * Sub-states of eePoweringUp.
+ */
+enum EPoweringUpSubState
+{
+	eePoweringUpRamp,
+	eePoweringUpResync //Blade is on, motion manager is catching up
+};
+
+/**
+ * Sub-states of eePoweringDown.
+ */
+enum EPoweringDownSubState
+{
+	eePoweringDownRamp,
+	eePoweringDownRelease //Blade is off, waiting for the button release
+};
+
+/**
+ * Sub-states of eePostSwing.
+ */
+enum EPostSwingSubState
+{
+	eePostSwingActive,
+	eePostSwingClashPending, //Clash arrived too soon after the swing sound
+	eePostSwingEnded //Swing ended before the minimum swing time
+};
+
+/**
+ * Sub-states of eeLockup.
+ */
+enum ELockupSubState
+{
+	eeLockupFlare, //Flash color held after lockup starts or an impact
+	eeLockupStrobeBase,
+	eeLockupStrobeFlash
+};
+
+/**
+ * Sub-states of eeBlaster.
+ */
+enum EBlasterSubState
+{
+	eeBlasterDeflect, //Deflect requested, respond this cycle
+	eeBlasterFlash
+};
+
+/**
+ * Enumeration of the events published to the saber state machine. Each
+ * state subscribes to the events it reacts to (see sStateEvents).
+ */
+enum ESaberEvent
+{
+	eeEvtClash,
+	eeEvtSwingStart,
+	eeEvtSwingEnd,
+	eeEvtActTap, //Activation button pressed and released
+	eeEvtActLongPress, //Activation button held for the power-down time
+	eeEvtAuxPress, //Auxiliary button went down
+	eeEvtAuxLongPress, //Auxiliary button held for the lockup time
+	eeEvtAuxRelease, //Auxiliary button released
+	eeEvtAuxTap, //Auxiliary button pressed and released, not a long press
+	eeEvtTimeout, //Timer armed by the current state expired
+	eeNumEvents
+};
+
+//Subscription masks have one bit per event
+static_assert(eeNumEvents <= EVENT_MAX_TYPES, "Too many events for the subscription mask");
+
+/**
+ * Enumeration of the orthogonal regions that run alongside the primary
+ * (blade) region of the saber state machine.
+ */
+enum ESaberRegion
+{
+	eeInputRegion, //Operated before Body() so gestures are handled the cycle they are detected
+	eeSoundRegion,
+	eeNumRegions
+};
+
+/**
+ * Enumeration of the sound region states.
+ */
+enum ESoundState
+{
+	eeSoundSilent,
+	eeSoundHum,
+	eeSoundLockup
+};
+
+/**
+ * Enumeration of the input region states.
+ */
+enum EInputState
+{
+	eeInputIdle,
+	eeInputActHeld,
+	eeInputAuxHeld
+};
+
+/**
+ * Sub-states of eeInputActHeld and eeInputAuxHeld.
+ */
+enum EInputSubState
+{
+	eeInputPressed,
+	eeInputLongPressed //Long press event already published
+};
+
 /**
  * This class serves as the primary state machine for the saber controlling
  * all higher-level functionality.
+ *
+ * No state waits inside Body(). Long-running actions such as the blade
+ * ramps are advanced one step per cycle using sub-states. Button and
+ * motion events are published and handled in the cycle they are detected,
+ * so a press or impact gets a visual response on the next Operate() cycle.
  */
 class SaberStateMachine : public StateMachine
 {
@@ -63,12 +183,14 @@ public:
 	 *     apBlade - Controls the blade
 	 *     apActButton - Activation button handler
 	 *     apAuxButton - Auxiliary button handler
+	 *     apToleranceData - Motion thresholds used by the motion manager
 	 */
 	SaberStateMachine(DIYinoSoundPlayer* apSoundPlayer,
 	           	   	  Mpu6050LiteMotionManager* apMotionManger,
 					  IBladeManager* apBlade,
 					  Button* apActButton,
-					  Button* apAuxButton);
+					  Button* apAuxButton,
+					  MPU6050LiteTolData* apToleranceData);
 
 	/**
 	 * Initialize components and get ready to run.
@@ -81,16 +203,154 @@ public:
 	 */
 	void Body();
 
+	/**
+	 * Operates the input and sound regions of the saber state machine.
+	 * Called by Operate(), before Body() for the input region and after it
+	 * for the sound region.
+	 *   Args:
+	 *     aRegion - Index of the region to operate (see ESaberRegion)
+	 */
+	void RegionBody(uint8_t aRegion);
+
 private:
 
+	/**
+	 * Operates the sound region. Keeps the hum going while the blade is on,
+	 * independent of which blade state is active.
+	 *   Args:
+	 *     arRegion - The sound region
+	 */
+	void SoundBody(StateRegion& arRegion);
+
+	/**
+	 * Operates the input region. Updates the buttons and tracks gestures
+	 * independent of which blade state is active, publishing them as
+	 * events. Runs before Body() so a gesture is handled in the cycle it
+	 * is detected.
+	 *   Args:
+	 *     arRegion - The input region
+	 */
+	void InputBody(StateRegion& arRegion);
+
+	/**
+	 * Is the blade in one of the powered-on states?
+	 * Returns:
+	 *   TRUE if the blade is on, FALSE otherwise.
+	 */
+	bool IsPoweredOn();
+
+	/**
+	 * Run one step of the gyro bias calibration and persist the offsets
+	 * when they have moved far enough from the saved ones.
+	 */
+	void Calibrate();
+
+	/**
+	 * Set the blade to the normal color.
+	 */
+	void ShowBaseColor();
+
+	/**
+	 * Set the blade to the flash color used for clashes and effects.
+	 */
+	void ShowFlashColor();
+
+	/**
+	 * Make a profile the active one. Copies it out of PROGMEM and updates
+	 * the sound module and motion thresholds without re-initializing
+	 * anything, so it is safe to call while the state machine is running.
+	 *   Args:
+	 *     aIndex - Index into gProfiles
+	 */
+	void ApplyProfile(uint8_t aIndex);
+
+	/**
+	 * Track the time between cycles and report when a new worst case
+	 * exceeds the expected bound.
+	 */
+	void CheckCycleTime();
+
+	/**
+	 * Publish motion and timer events. Clash flags that repeat within the
+	 * settle time are coalesced, swings are published on their start and
+	 * end edges.
+	 */
+	void PublishEvents();
+
+	/**
+	 * React to an event the current state subscribes to. Handles the
+	 * gestures common to all powered-on states, then the state's own.
+	 *   Args:
+	 *     arEvent - The event
+	 */
+	void HandleEvent(const Event& arEvent);
+
+	/**
+	 * React to an event specific to the current state.
+	 *   Args:
+	 *     arEvent - The event
+	 */
+	void HandleStateEvent(const Event& arEvent);
+
+	/**
+	 * Publish a timeout event after a delay, unless the state changes first.
+	 *   Args:
+	 *     aDuration - Time (in milliseconds) until the timeout
+	 */
+	void ArmTimeout(unsigned int aDuration);
+
+	/**
+	 * Switch to the next profile, announce its font and restart the
+	 * profile selection timeout.
+	 */
+	void NextProfile();
+
+	/**
+	 * Scale the hum volume with the angular speed of the blade using a
+	 * precomputed response curve. Updates are rate-limited and only sent
+	 * when the volume changes meaningfully.
+	 */
+	void ModulateHum();
+
+	/**
+	 * Set the sound module volume if it differs from the last one sent.
+	 *   Args:
+	 *     aVolume - New volume
+	 */
+	void SetVolume(uint8_t aVolume);
+
 	DIYinoSoundPlayer* mpSoundPlayer; //Plays sounds
 	Mpu6050LiteMotionManager* mpMotion; //Detects motion
 	IBladeManager* mpBlade; //Controls the blade
 	Button* mpActButton; //Activation button
 	Button* mpAuxButton; //Auxiliary button
+	MPU6050LiteTolData* mpToleranceData; //Motion thresholds
+
+	StateRegion mRegions[eeNumRegions]; //Sound and input regions
+
+	SettingsStore mSettingsStore; //Loads and saves settings to EEPROM
+	Settings mSettings; //User settings
+	GyroCalibrator mCalibrator; //Gyro bias calibration
+
+	SaberProfile mProfile; //Active profile (copied from PROGMEM)
+	uint8_t mProfileIndex; //Index of the active profile
 
-	unsigned long mLastClashTime; //Time when the last clash event occurred
 	unsigned long mLastSwingTime; //Time when the last swing event occurred
+	uint8_t mLockupStrobeTime; //Duration of the current lockup strobe step
+	unsigned long mLastCycleTime; //Time when the last cycle started
+	unsigned long mMaxCycleTime; //Longest time between cycles seen so far
+
+	EventQueue mEvents; //Events waiting to be handled
+	bool mSwinging; //Swing start was published and end was not yet
+	bool mTimeoutArmed; //Timeout event is pending
+	int mTimeoutState; //State that armed the timeout
+	unsigned long mTimeoutStart; //Time when the timeout was armed
+	unsigned int mTimeoutDuration; //Time until the timeout
+
+	uint8_t mSentVolume; //Last volume sent to the sound module
+	unsigned long mHumUpdateTime; //Time of the last hum modulation update
+	unsigned long mVolumeReportTime; //Time of the last update rate report
+	uint16_t mVolumeUpdates; //Volume commands sent since the last report
 };
 
 #endif /* SABERSTATEMACHINE_H_ */
@@ -26,10 +26,13 @@
 
 #include <USaber.h>
 
+/**
+ * User settings that are persisted to EEPROM by the SettingsStore.
+ */
 struct Settings
 {
-	uint8_t mSelectedProfile;
-	uint8_t mSoundVolume;
+	uint8_t mSelectedProfile; //Index into gProfiles
+	int16_t mGyroOffset[3]; //Gyro bias offsets (MPU6050 offset register units)
 
 	//TODO: Add more settings
 };
@@ -0,0 +1,104 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * SettingsStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <EEPROM.h>
+#include "Config.h"
+#include "SettingsStore.h"
+
+//Change this whenever the layout of the Settings struct changes
+#define SETTINGS_SIGNATURE 0xA2
+
+SettingsStore::SettingsStore(int aAddress) :
+mAddress(aAddress),
+mSaving(false)
+{
+	//Handled by initializer list
+}
+
+SettingsStore::~SettingsStore()
+{
+	// Do nothing
+}
+
+bool SettingsStore::Load(Settings& arSettings)
+{
+	bool lValid = false;
+
+	if(SETTINGS_SIGNATURE == EEPROM.read(mAddress))
+	{
+		EEPROM.get(mAddress + 1, arSettings);
+		lValid = true;
+	}
+	else
+	{
+		SetDefaults(arSettings);
+	}
+
+	return lValid;
+}
+
+void SettingsStore::Save(const Settings& arSettings)
+{
+	mPending = arSettings;
+#ifndef FX_BENCHMARK
+	mSaving = true;
+#endif
+}
+
+bool SettingsStore::Update()
+{
+	if(mSaving)
+	{
+		const uint8_t* lpBytes = reinterpret_cast<const uint8_t*>(&mPending);
+		uint8_t lIndex = 0;
+
+		//Find the next byte that differs, reading is cheap
+		while(lIndex < sizeof(Settings) &&
+			  EEPROM.read(mAddress + 1 + lIndex) == lpBytes[lIndex])
+		{
+			lIndex++;
+		}
+
+		if(lIndex < sizeof(Settings))
+		{
+			EEPROM.write(mAddress + 1 + lIndex, lpBytes[lIndex]);
+		}
+		//Signature goes last so a blank EEPROM isn't marked valid early
+		else if(SETTINGS_SIGNATURE != EEPROM.read(mAddress))
+		{
+			EEPROM.write(mAddress, SETTINGS_SIGNATURE);
+		}
+		else
+		{
+			mSaving = false;
+		}
+	}
+
+	return mSaving;
+}
+
+void SettingsStore::SetDefaults(Settings& arSettings)
+{
+	memset(&arSettings, 0, sizeof(Settings));
+	arSettings.mSelectedProfile = 0;
+}
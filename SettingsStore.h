@@ -0,0 +1,99 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * SettingsStore.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SETTINGSSTORE_H_
+#define SETTINGSSTORE_H_
+
+#include "Settings.h"
+
+/**
+ * This class loads and saves the user settings to EEPROM. A signature byte
+ * is stored ahead of the settings so that a blank or out-of-date EEPROM is
+ * detected and replaced with defaults.
+ *
+ * Each EEPROM cell takes about 3.4ms to write, so saving is spread out:
+ * Save() only takes a copy of the settings and Update() writes at most one
+ * changed cell per call.
+ */
+class SettingsStore
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *   aAddress - EEPROM address where the settings are stored.
+	 */
+	SettingsStore(int aAddress = 0);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~SettingsStore();
+
+	/**
+	 * Load the settings from EEPROM. If EEPROM does not hold valid
+	 * settings, the defaults are loaded instead.
+	 * Args:
+	 *   arSettings - Settings to fill in
+	 * Returns:
+	 *   TRUE if valid settings were loaded, FALSE if defaults were used.
+	 */
+	bool Load(Settings& arSettings);
+
+	/**
+	 * Start saving the settings to EEPROM. Only bytes that have changed are
+	 * written, so calling this with unchanged settings costs no EEPROM wear.
+	 * A save that is still in progress is replaced by the new one.
+	 * Benchmark builds (FX_BENCHMARK) never write to EEPROM.
+	 * Args:
+	 *   arSettings - Settings to save
+	 */
+	void Save(const Settings& arSettings);
+
+	/**
+	 * Write the next changed byte of a save in progress. Call this every
+	 * cycle.
+	 * Returns:
+	 *   TRUE while a save is in progress, FALSE once it is done.
+	 */
+	bool Update();
+
+	/**
+	 * Fill in the default settings.
+	 * Args:
+	 *   arSettings - Settings to fill in
+	 */
+	void SetDefaults(Settings& arSettings);
+
+private:
+	//EEPROM address of the signature byte, settings follow it
+	int mAddress;
+
+	//Settings being saved
+	Settings mPending;
+
+	//Is a save in progress?
+	bool mSaving;
+};
+
+#endif /* SETTINGSSTORE_H_ */
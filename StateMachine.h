@@ -26,11 +26,158 @@
 
 #include <Arduino.h> //for millis()
 
+/**
+ * Class holds the bookkeeping for one region of a state machine. A region
+ * tracks a state, a nested sub-state within that state, and the times when
+ * each last changed. Several regions can be operated side-by-side so that
+ * independent concerns (e.g. blade, sound, input) each get their own state
+ * without having to be encoded into one combined enumeration.
+ *
+ * SRAM cost on AVR is 18 bytes per region. Updating a region is a fixed
+ * number of compares and assignments, so it takes constant time.
+ */
+class StateRegion
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	StateRegion() :
+	mState(0),
+	mLastState(-1),
+	mSubState(0),
+	mLastSubState(0),
+	mIsNewState(false),
+	mIsNewSubState(false),
+	mStateChangeTime(0),
+	mSubStateChangeTime(0)
+	{
+
+	}
+
+	/**
+	 * Update the flags that indicate a state or sub-state change occurred
+	 * last cycle. Call this once per cycle before acting on the region.
+	 */
+	inline void Update()
+	{
+		mIsNewState = (mLastState != mState);
+		mIsNewSubState = mIsNewState || (mLastSubState != mSubState);
+
+		//Store the states for next cycle
+		mLastState = mState;
+		mLastSubState = mSubState;
+	}
+
+	/**
+	 * Change to a new state. The sub-state is reset to zero.
+	 *   Args:
+	 *     aState - New state to change to.
+	 */
+	inline void ChangeState(const int& aState)
+	{
+		mState = aState;
+		mSubState = 0;
+		mStateChangeTime = millis();
+		mSubStateChangeTime = mStateChangeTime;
+	}
+
+	/**
+	 * Change to a new sub-state within the current state.
+	 *   Args:
+	 *     aSubState - New sub-state to change to.
+	 */
+	inline void ChangeSubState(const int& aSubState)
+	{
+		mSubState = aSubState;
+		mSubStateChangeTime = millis();
+	}
+
+	/**
+	 * Get the current state.
+	 * Returns:
+	 *   The current state.
+	 */
+	inline int GetState() const
+	{
+		return mState;
+	}
+
+	/**
+	 * Get the current sub-state.
+	 * Returns:
+	 *   The current sub-state.
+	 */
+	inline int GetSubState() const
+	{
+		return mSubState;
+	}
+
+	/**
+	 * Is this the first cycle after a state change?
+	 * Returns:
+	 *   TRUE if the state changed last cycle, FALSE otherwise.
+	 */
+	inline bool IsNewState() const
+	{
+		return mIsNewState;
+	}
+
+	/**
+	 * Is this the first cycle after a sub-state change? This is also TRUE
+	 * on the first cycle of a new state.
+	 * Returns:
+	 *   TRUE if the sub-state changed last cycle, FALSE otherwise.
+	 */
+	inline bool IsNewSubState() const
+	{
+		return mIsNewSubState;
+	}
+
+	/**
+	 * How long has the region been in the current state?
+	 * Returns:
+	 *   Time (in milliseconds) since the last state change.
+	 */
+	inline unsigned long GetStateTime() const
+	{
+		return millis() - mStateChangeTime;
+	}
+
+	/**
+	 * How long has the region been in the current sub-state?
+	 * Returns:
+	 *   Time (in milliseconds) since the last sub-state change.
+	 */
+	inline unsigned long GetSubStateTime() const
+	{
+		return millis() - mSubStateChangeTime;
+	}
+
+protected:
+	int mState; //Current state ( set this only with ChangeState() )
+	int mLastState; //Last state
+	int mSubState; //Current sub-state ( set this only with ChangeSubState() )
+	int mLastSubState; //Last sub-state
+	bool mIsNewState; //Flag set to true during first cycle after state change
+	bool mIsNewSubState; //Flag set to true during first cycle after sub-state change
+
+	unsigned long mStateChangeTime; //Time when state changed
+	unsigned long mSubStateChangeTime; //Time when sub-state changed
+};
+
 /**
  * Class defines a generic state machine base class. Derived classes should
  * implement the Init() and Body() methods.
+ *
+ * The state machine itself is the primary region. Derived classes may also
+ * register additional orthogonal regions with SetRegions() and implement
+ * RegionBody() to operate them. All regions are updated and operated during
+ * the same Operate() call. Regions whose results Body() acts on in the same
+ * cycle (e.g. input) can be registered to run ahead of Body().
  */
-class StateMachine
+class StateMachine : public StateRegion
 {
 public:
 
@@ -38,8 +185,9 @@ public:
 	 * Constructor.
 	 */
 	StateMachine() :
-	mIsNewState(false),
-	mStateChangeTime(0)
+	mpRegions(NULL),
+	mNumRegions(0),
+	mNumEarlyRegions(0)
 	{
 
 	}
@@ -65,6 +213,19 @@ public:
 	 */
 	virtual void Body() = 0;
 
+	/**
+	 * Subclasses that register additional regions should implement the body
+	 * of each region here. Operate() calls this once per region per cycle,
+	 * before Body() for the early regions and after it for the rest (see
+	 * SetRegions()).
+	 *   Args:
+	 *     aRegion - Index of the region to operate.
+	 */
+	virtual void RegionBody(uint8_t /*aRegion*/)
+	{
+		//Do nothing
+	}
+
 	/**
 	 * Call this method from a loop to operate the state machine. This method
 	 * will perform state management bookkeeping as well as call the Body()
@@ -73,40 +234,49 @@ public:
 	 */
 	inline void Operate()
 	{
-		//Update the flag that indicates a state change occurred last cycle
-		if(mLastState != mState)
+		//Update the flags that indicate a state change occurred last cycle
+		Update();
+		for(uint8_t lRegion = 0; lRegion < mNumRegions; lRegion++)
 		{
-			mIsNewState = true;
+			mpRegions[lRegion].Update();
 		}
-		else
-		{
-			mIsNewState = false;
-		}
-
-		//Store the state for next cycle
-		mLastState = mState;
 
 		//Call the user-defined operations
+		uint8_t lRegion = 0;
+		for(; lRegion < mNumEarlyRegions; lRegion++)
+		{
+			RegionBody(lRegion);
+		}
 		Body();
+		for(; lRegion < mNumRegions; lRegion++)
+		{
+			RegionBody(lRegion);
+		}
 	}
 
+protected:
+
 	/**
-	 * Change to a new state.
+	 * Register additional orthogonal regions to be operated alongside the
+	 * primary region.
 	 *   Args:
-	 *     aState - New state to change to.
+	 *     apRegions - Array of regions (owned by the derived class)
+	 *     aNumRegions - Number of regions in the array
+	 *     aNumEarlyRegions - Number of regions at the start of the array
+	 *                        to operate before Body() instead of after it
 	 */
-	inline void ChangeState(const int& aState)
+	inline void SetRegions(StateRegion* apRegions,
+	                       uint8_t aNumRegions,
+	                       uint8_t aNumEarlyRegions = 0)
 	{
-		mState = aState;
-		mStateChangeTime = millis();
+		mpRegions = apRegions;
+		mNumRegions = aNumRegions;
+		mNumEarlyRegions = aNumEarlyRegions;
 	}
 
-protected:
-	int mState; //Current state ( set this only with ChangeState() )
-	int mLastState; //Last state
-	bool mIsNewState; //Flag set to true during first cycle after state change
-
-	unsigned long mStateChangeTime; //Time when state changed
+	StateRegion* mpRegions; //Additional regions
+	uint8_t mNumRegions; //Number of additional regions
+	uint8_t mNumEarlyRegions; //Number of additional regions operated before Body()
 };
 
 
@@ -0,0 +1,170 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * EventQueueTest.cpp
+ *   Checks of EventQueue on its own: coalescing of repeated events,
+ *   dropping the oldest event when full and filtering by subscription mask.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include "EventQueue.h"
+
+#define CHECK(aCondition) Check((aCondition), #aCondition, __LINE__)
+
+//Event types used by the checks
+#define TYPE_A 0
+#define TYPE_B 1
+#define TYPE_C 2
+#define TYPE_D 3
+
+static unsigned int sChecks = 0;
+static unsigned int sFailures = 0;
+
+/**
+ * Record the outcome of a check and report it if it failed.
+ */
+static void Check(bool aPassed, const char* apText, int aLine)
+{
+	sChecks++;
+	if(!aPassed)
+	{
+		sFailures++;
+		printf("  FAIL line %d: %s\n", aLine, apText);
+	}
+}
+
+/**
+ * Pop every event of any type into an array.
+ * Returns:
+ *   Number of events popped.
+ */
+static unsigned int Drain(EventQueue& arQueue, uint8_t* apTypes, unsigned int aMax)
+{
+	unsigned int lCount = 0;
+	Event lEvent;
+
+	while(lCount < aMax && arQueue.Pop(lEvent, 0xFFFF))
+	{
+		apTypes[lCount++] = lEvent.mType;
+	}
+
+	return lCount;
+}
+
+static void TestCoalescing(EventQueue& arQueue)
+{
+	uint8_t lTypes[EVENT_QUEUE_SIZE];
+
+	//Repeats inside the window are dropped, the first one is kept
+	CHECK(arQueue.Publish(TYPE_A, 200));
+	delay(50);
+	CHECK(!arQueue.Publish(TYPE_A, 200));
+	delay(100);
+	CHECK(!arQueue.Publish(TYPE_A, 200));
+
+	//The window runs from the last queued event, not the last attempt
+	delay(60);
+	CHECK(arQueue.Publish(TYPE_A, 200));
+
+	//Other types and publishes without a window are not affected
+	CHECK(arQueue.Publish(TYPE_B, 200));
+	CHECK(arQueue.Publish(TYPE_A));
+	CHECK(arQueue.Publish(TYPE_A));
+
+	CHECK(5 == Drain(arQueue, lTypes, EVENT_QUEUE_SIZE));
+
+	//Popping does not reset the window
+	CHECK(!arQueue.Publish(TYPE_B, 200));
+
+	//Types past the coalescing entries are always queued
+	CHECK(arQueue.Publish(TYPE_C, 200));
+	CHECK(arQueue.Publish(TYPE_C, 200));
+	CHECK(2 == Drain(arQueue, lTypes, EVENT_QUEUE_SIZE));
+}
+
+static void TestDropOldest(EventQueue& arQueue)
+{
+	uint8_t lTypes[EVENT_QUEUE_SIZE + 2];
+
+	//Fill past capacity, alternating types so the order shows
+	for(uint8_t i = 0; i < EVENT_QUEUE_SIZE + 2; i++)
+	{
+		CHECK(arQueue.Publish(i % 2));
+	}
+
+	//The first two were dropped and the rest come out in order
+	CHECK(EVENT_QUEUE_SIZE == Drain(arQueue, lTypes, EVENT_QUEUE_SIZE + 2));
+	for(uint8_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK((i % 2) == lTypes[i]);
+	}
+}
+
+static void TestMask(EventQueue& arQueue)
+{
+	Event lEvent;
+
+	arQueue.Publish(TYPE_A);
+	arQueue.Publish(TYPE_B);
+	delay(5);
+	unsigned long lTime = millis();
+	arQueue.Publish(TYPE_C);
+	arQueue.Publish(TYPE_D);
+
+	//Unsubscribed events ahead of a subscribed one are discarded
+	CHECK(arQueue.Pop(lEvent, EVENT_BIT(TYPE_C) | EVENT_BIT(TYPE_D)));
+	CHECK(TYPE_C == lEvent.mType);
+	CHECK(lTime == lEvent.mTime);
+
+	//Events behind it are left for the next pop
+	CHECK(arQueue.Pop(lEvent, EVENT_BIT(TYPE_D)));
+	CHECK(TYPE_D == lEvent.mType);
+
+	//A pop with no subscribed events empties the queue
+	arQueue.Publish(TYPE_A);
+	CHECK(!arQueue.Pop(lEvent, EVENT_BIT(TYPE_B)));
+	CHECK(!arQueue.Pop(lEvent, 0xFFFF));
+}
+
+/**
+ * Run one group of checks on a fresh queue.
+ */
+static void Run(const char* apName, void (*apTest)(EventQueue&))
+{
+	EventQueue lQueue;
+	unsigned int lFailures = sFailures;
+
+	Shim::Reset();
+	delay(1000);
+	apTest(lQueue);
+
+	printf("%s %s\n", (lFailures == sFailures) ? "pass" : "FAIL", apName);
+}
+
+int main()
+{
+	Run("coalescing", TestCoalescing);
+	Run("drop oldest when full", TestDropOldest);
+	Run("subscription mask", TestMask);
+
+	printf("event queue: %u checks, %u failed\n", sChecks, sFailures);
+
+	return (0 == sFailures) ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * FuzzTest.cpp
+ *   Property test of SaberStateMachine. Runs random input traces through
+ *   the harness and checks that every cycle stays within the cycle
+ *   budget without waiting, and that the saber can always be turned off
+ *   afterwards. Failing traces are shrunk to a short scenario that
+ *   reproduces the same failure.
+ *
+ *   Usage: FuzzTest [traces] [first seed]
+ *          FuzzTest -r <seed>   (rerun one seed with the debug output on)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <random>
+#include "SaberHarness.h"
+
+#define FUZZ_DEFAULT_TRACES 300
+#define FUZZ_MIN_STEPS 4
+#define FUZZ_MAX_STEPS 40
+
+typedef std::vector<HarnessStep> Trace;
+
+/**
+ * Build a random trace and conditions from a seed.
+ * Args:
+ *   aSeed - Seed, the same seed always gives the same trace
+ *   arConfig - Filled in with the conditions
+ *   arTrace - Filled in with the steps
+ */
+static void MakeTrace(unsigned long aSeed, HarnessConfig& arConfig, Trace& arTrace)
+{
+	std::mt19937 lRng(aSeed);
+	std::uniform_real_distribution<float> lUnit(0.0f, 1.0f);
+
+	//Some gyros are badly off, and now and then the sensor is missing
+	for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+	{
+		arConfig.mGyroBias[lAxis] = (lUnit(lRng) - 0.5f) * 8.0f;
+	}
+	arConfig.mGyroNoise = lUnit(lRng) * 0.5f;
+	arConfig.mMpuPresent = (lUnit(lRng) > 0.05f);
+
+	arTrace.clear();
+	unsigned int lSteps = FUZZ_MIN_STEPS + lRng() % (FUZZ_MAX_STEPS - FUZZ_MIN_STEPS + 1);
+	for(unsigned int lIndex = 0; lIndex < lSteps; lIndex++)
+	{
+		HarnessStep lStep;
+
+		//Mostly short steps to hit races, some long enough for holds
+		float lKind = lUnit(lRng);
+		if(lKind < 0.4f)
+		{
+			lStep.mDuration = 1 + lRng() % 60;
+		}
+		else if(lKind < 0.85f)
+		{
+			lStep.mDuration = 60 + lRng() % 600;
+		}
+		else
+		{
+			lStep.mDuration = 600 + lRng() % 2400;
+		}
+
+		lStep.mActHeld = (lUnit(lRng) < 0.25f);
+		lStep.mAuxHeld = (lUnit(lRng) < 0.25f);
+		lStep.mClash = (lUnit(lRng) < 0.15f);
+		lStep.mSwing = (lUnit(lRng) < 0.3f) ? (1 + lRng() % eeLarge) : (uint8_t)eeNone;
+
+		arTrace.push_back(lStep);
+	}
+}
+
+/**
+ * Does the trace still fail the same way?
+ */
+static bool StillFails(SaberHarness& arHarness, const HarnessConfig& arConfig,
+					   const Trace& arTrace, EHarnessResult aExpected)
+{
+	return (aExpected == arHarness.RunTrace(arConfig, arTrace));
+}
+
+/**
+ * Shrink a failing trace. First drop chunks of steps (delta debugging),
+ * then join steps with the same inputs and simplify the steps that are
+ * left one input at a time.
+ * Args:
+ *   arHarness - Harness to rerun the trace on
+ *   arConfig - Conditions of the failing run
+ *   arTrace - Failing trace, replaced by the shrunk one
+ *   aExpected - The failure to keep
+ */
+static void Shrink(SaberHarness& arHarness, const HarnessConfig& arConfig,
+				   Trace& arTrace, EHarnessResult aExpected)
+{
+	size_t lChunks = 2;
+	while(arTrace.size() >= 2)
+	{
+		size_t lChunkSize = (arTrace.size() + lChunks - 1) / lChunks;
+		bool lReduced = false;
+
+		for(size_t lStart = 0; lStart < arTrace.size() && !lReduced; lStart += lChunkSize)
+		{
+			Trace lCandidate(arTrace.begin(), arTrace.begin() + lStart);
+			size_t lEnd = min(lStart + lChunkSize, arTrace.size());
+			lCandidate.insert(lCandidate.end(), arTrace.begin() + lEnd, arTrace.end());
+
+			if(StillFails(arHarness, arConfig, lCandidate, aExpected))
+			{
+				arTrace = lCandidate;
+				lChunks = max(lChunks - 1, (size_t)2);
+				lReduced = true;
+			}
+		}
+
+		if(!lReduced)
+		{
+			if(lChunks >= arTrace.size())
+			{
+				break;
+			}
+			lChunks = min(lChunks * 2, arTrace.size());
+		}
+	}
+
+	bool lChanged = true;
+	while(lChanged)
+	{
+		lChanged = false;
+
+		//Join steps with the same inputs, this keeps most of the timing
+		for(size_t lIndex = 0; lIndex + 1 < arTrace.size(); lIndex++)
+		{
+			const HarnessStep& lrStep = arTrace[lIndex];
+			const HarnessStep& lrNext = arTrace[lIndex + 1];
+			if(lrStep.mActHeld == lrNext.mActHeld && lrStep.mAuxHeld == lrNext.mAuxHeld &&
+			   lrStep.mSwing == lrNext.mSwing && !lrNext.mClash &&
+			   lrStep.mDuration + lrNext.mDuration <= 0xFFFF)
+			{
+				Trace lCandidate = arTrace;
+				lCandidate[lIndex].mDuration += lrNext.mDuration;
+				lCandidate.erase(lCandidate.begin() + lIndex + 1);
+
+				if(StillFails(arHarness, arConfig, lCandidate, aExpected))
+				{
+					arTrace = lCandidate;
+					lChanged = true;
+				}
+			}
+		}
+
+		for(size_t lIndex = 0; lIndex < arTrace.size(); lIndex++)
+		{
+			for(uint8_t lEdit = 0; lEdit < 5; lEdit++)
+			{
+				Trace lCandidate = arTrace;
+				HarnessStep& lrStep = lCandidate[lIndex];
+				switch(lEdit)
+				{
+				case 0:
+					lrStep.mClash = false;
+					break;
+				case 1:
+					lrStep.mSwing = (lrStep.mSwing > eeNone) ? lrStep.mSwing - 1 : (uint8_t)eeNone;
+					break;
+				case 2:
+					lrStep.mAuxHeld = false;
+					break;
+				case 3:
+					lrStep.mActHeld = false;
+					break;
+				default:
+					lrStep.mDuration = max(lrStep.mDuration / 2, 1);
+					break;
+				}
+
+				if(0 != memcmp(&lrStep, &arTrace[lIndex], sizeof(HarnessStep)) &&
+				   StillFails(arHarness, arConfig, lCandidate, aExpected))
+				{
+					arTrace = lCandidate;
+					lChanged = true;
+				}
+			}
+		}
+	}
+}
+
+int main(int aArgc, char** aArgv)
+{
+	SaberHarness lHarness;
+	HarnessConfig lConfig;
+	Trace lTrace;
+
+	//Rerun one seed with the saber's debug output
+	if(3 == aArgc && 0 == strcmp(aArgv[1], "-r"))
+	{
+		unsigned long lSeed = strtoul(aArgv[2], 0, 0);
+		MakeTrace(lSeed, lConfig, lTrace);
+		Serial.SetEcho(true);
+		EHarnessResult lResult = lHarness.RunTrace(lConfig, lTrace);
+		Serial.SetEcho(false);
+		printf("seed %lu: %s %s\n", lSeed, SaberHarness::ResultName(lResult), lHarness.GetFailure());
+		SaberHarness::PrintTrace(lConfig, lTrace);
+		return (eeHarnessPass == lResult) ? 0 : 1;
+	}
+
+	unsigned long lTraces = (aArgc > 1) ? strtoul(aArgv[1], 0, 0) : FUZZ_DEFAULT_TRACES;
+	unsigned long lFirstSeed = (aArgc > 2) ? strtoul(aArgv[2], 0, 0) : 1;
+	unsigned long lFailures = 0;
+	unsigned long lCycles = 0;
+	unsigned long lMaxCycleUs = 0;
+	unsigned long lEndStates[eeMenu + 1] = { 0 };
+
+	for(unsigned long lSeed = lFirstSeed; lSeed < lFirstSeed + lTraces; lSeed++)
+	{
+		MakeTrace(lSeed, lConfig, lTrace);
+		EHarnessResult lResult = lHarness.RunTrace(lConfig, lTrace);
+		lCycles += lHarness.mCycles;
+		lMaxCycleUs = max(lMaxCycleUs, lHarness.mMaxCycleUs);
+		if(eeHarnessPass == lResult)
+		{
+			lEndStates[lHarness.mTraceEndState]++;
+		}
+
+		if(eeHarnessPass != lResult)
+		{
+			lFailures++;
+			printf("FAIL seed %lu: %s\n", lSeed, lHarness.GetFailure());
+
+			size_t lOriginalSteps = lTrace.size();
+			Shrink(lHarness, lConfig, lTrace, lResult);
+			lHarness.RunTrace(lConfig, lTrace);
+			printf("  shrunk %u -> %u steps, %s\n", (unsigned int)lOriginalSteps,
+				   (unsigned int)lTrace.size(), lHarness.GetFailure());
+			SaberHarness::PrintTrace(lConfig, lTrace);
+		}
+	}
+
+	//Recovery was checked from each of these states
+	printf("recovered to eeOff from states:");
+	for(int lState = eeBoot; lState <= eeMenu; lState++)
+	{
+		printf(" %d:%lu", lState, lEndStates[lState]);
+	}
+	printf("\n");
+
+	printf("fuzz: %lu traces, %lu cycles, slowest cycle %lu us, %lu failed\n",
+		   lTraces, lCycles, lMaxCycleUs, lFailures);
+
+	return (0 == lFailures) ? 0 : 1;
+}
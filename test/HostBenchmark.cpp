@@ -0,0 +1,54 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * HostBenchmark.cpp
+ *   Runs the sketch's FX_BENCHMARK build on the host. The sketch is
+ *   compiled with FX_BENCHMARK defined, so setup() runs the benchmark and
+ *   prints its rows (see Benchmark.h) to stdout. Fails if the run wrote
+ *   to EEPROM, the benchmark must leave the user's settings alone.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+
+void setup();
+
+int main()
+{
+	Shim::Reset();
+	EEPROM.Erase();
+
+	//A biased gyro, so the calibration in eeOff has offsets it wants to save
+	Wire.mMpu.mBias[0] = 3.0f;
+	Wire.mMpu.mBias[1] = -2.0f;
+	Wire.mMpu.mBias[2] = 1.5f;
+	Serial.SetEcho(true);
+	setup();
+
+	if(0 != EEPROM.mWrites)
+	{
+		printf("bench,FAIL,%lu EEPROM cells written\n", EEPROM.mWrites);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * IdleReplay.cpp
+ *   Replays an idle motion trace through the simulated MPU6050 and
+ *   GyroCalibrator and counts how often the swing and clash thresholds
+ *   would fire, once on the raw sensor and once after calibrating.
+ *
+ *   Usage: IdleReplay [trace.csv] [warm-up seconds]
+ *
+ *   The trace has one sample per line: t_ms,gx,gy,gz[,ax,ay,az] with rates
+ *   in deg/s and acceleration in g. Lines starting with '#' or a letter
+ *   are skipped. Without a file, a synthetic trace is generated: the
+ *   saber lies still for the warm-up and is then held in the hand.
+ *
+ *   The calibrated run lets GyroCalibrator work during the warm-up, as it
+ *   does while the saber is off, and freezes the offsets after it. Only
+ *   samples after the warm-up are counted, in both runs.
+ *
+ *   Threshold model: the USaber motion manager's internal scaling isn't
+ *   reproduced here. A swing level fires when the L1 angular speed goes
+ *   above the profile's threshold taken as deg/s. A clash fires when the
+ *   acceleration magnitude changes by more than the clash threshold in
+ *   hundredths of a g between samples. A level has to stay quiet for
+ *   MIN_SWING_INTERVAL before it can fire again. The counts are meant for
+ *   comparing the two runs, not as absolute rates.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <vector>
+#include <Wire.h>
+#include "../GyroCalibrator.h"
+#include "../Profiles.h"
+
+#define REPLAY_DEFAULT_WARMUP_S 10
+#define MIN_SWING_INTERVAL 200 //Same as SaberStateMachine
+
+//Synthetic trace, MPU6050 zero-rate offset is specified up to +-20 deg/s
+#define SYNTH_RATE_HZ 500
+#define SYNTH_LENGTH_S 130
+#define SYNTH_NOISE_DPS 0.3f
+#define SYNTH_TREMOR_DPS 3.0f //Hand tremor while held
+#define SYNTH_TREMOR_HZ 9.0f
+#define SYNTH_ACCEL_NOISE_G 0.01f
+
+static const float sSynthBias[3] = { 12.0f, -15.0f, 20.0f };
+static const float sSynthDrift[3] = { 0.02f, -0.01f, 0.03f }; //deg/s per s
+
+/**
+ * One sample of the trace.
+ */
+struct ReplaySample
+{
+	unsigned long mTime; //ms
+	float mGyro[3]; //deg/s
+	float mAccel[3]; //g
+};
+
+/**
+ * Rising-edge counter with a quiet time before it can fire again.
+ */
+struct TriggerCounter
+{
+	bool mAbove;
+	unsigned long mBelowSince;
+	unsigned long mCount;
+};
+
+/**
+ * Count a trigger if the value crossed the threshold.
+ */
+static void CountTrigger(TriggerCounter& arCounter, bool aAbove, unsigned long aTime)
+{
+	if(aAbove && !arCounter.mAbove && aTime - arCounter.mBelowSince >= MIN_SWING_INTERVAL)
+	{
+		arCounter.mCount++;
+	}
+	if(!aAbove && arCounter.mAbove)
+	{
+		arCounter.mBelowSince = aTime;
+	}
+	arCounter.mAbove = aAbove;
+}
+
+/**
+ * Load a trace from a CSV file.
+ * Returns:
+ *   TRUE if at least one sample was read, FALSE otherwise.
+ */
+static bool LoadTrace(const char* apPath, std::vector<ReplaySample>& arSamples)
+{
+	FILE* lpFile = fopen(apPath, "r");
+	char lLine[256];
+
+	while(0 != lpFile && 0 != fgets(lLine, sizeof(lLine), lpFile))
+	{
+		ReplaySample lSample = { 0, { 0, 0, 0 }, { 0, 0, 1.0f } };
+		if('#' == lLine[0] || isalpha((unsigned char)lLine[0]))
+		{
+			continue;
+		}
+
+		int lFields = sscanf(lLine, "%lu,%f,%f,%f,%f,%f,%f", &lSample.mTime,
+							 &lSample.mGyro[0], &lSample.mGyro[1], &lSample.mGyro[2],
+							 &lSample.mAccel[0], &lSample.mAccel[1], &lSample.mAccel[2]);
+		if(lFields >= 4)
+		{
+			arSamples.push_back(lSample);
+		}
+	}
+
+	if(0 != lpFile)
+	{
+		fclose(lpFile);
+	}
+
+	return !arSamples.empty();
+}
+
+/**
+ * Generate the synthetic trace.
+ */
+static void MakeTrace(unsigned long aWarmupMs, std::vector<ReplaySample>& arSamples)
+{
+	randomSeed(1);
+
+	for(unsigned long lIndex = 0; lIndex < SYNTH_LENGTH_S * SYNTH_RATE_HZ; lIndex++)
+	{
+		ReplaySample lSample;
+		lSample.mTime = lIndex * 1000UL / SYNTH_RATE_HZ;
+		float lSeconds = lSample.mTime / 1000.0f;
+		bool lHeld = (lSample.mTime >= aWarmupMs);
+
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			float lNoise = SYNTH_NOISE_DPS * (random(2001) / 1000.0f - 1.0f);
+			float lTremor = lHeld ? SYNTH_TREMOR_DPS * sinf(2.0f * (float)M_PI * SYNTH_TREMOR_HZ * lSeconds + lAxis) : 0;
+			lSample.mGyro[lAxis] = sSynthBias[lAxis] + sSynthDrift[lAxis] * lSeconds + lNoise + lTremor;
+			lSample.mAccel[lAxis] = ((2 == lAxis) ? 1.0f : 0) + SYNTH_ACCEL_NOISE_G * (random(2001) / 1000.0f - 1.0f);
+		}
+
+		arSamples.push_back(lSample);
+	}
+}
+
+/**
+ * Replay the trace and print the trigger counts.
+ * Args:
+ *   arSamples - Trace to replay
+ *   aWarmupMs - Length of the still period at the start
+ *   aCalibrate - Run the calibrator during the warm-up?
+ */
+static void Replay(const std::vector<ReplaySample>& arSamples, unsigned long aWarmupMs, bool aCalibrate)
+{
+	SaberProfile lProfile;
+	memcpy_P(&lProfile, &gProfiles[0], sizeof(SaberProfile));
+	const uint8_t lThresholds[3] = { lProfile.mSwingSmall, lProfile.mSwingMedium, lProfile.mSwingLarge };
+
+	Shim::Reset();
+	Wire.mMpu.Reset();
+
+	GyroCalibrator lCalibrator;
+	const int16_t lZero[3] = { 0, 0, 0 };
+	lCalibrator.Init(lZero);
+
+	TriggerCounter lSwing[3];
+	TriggerCounter lClash;
+	memset(lSwing, 0, sizeof(lSwing));
+	memset(&lClash, 0, sizeof(lClash));
+	float lLastAccel = -1;
+	unsigned long lMeasured = 0;
+	unsigned long lStart = 0;
+	unsigned long lEnd = 0;
+
+	for(size_t lIndex = 0; lIndex < arSamples.size(); lIndex++)
+	{
+		const ReplaySample& lrSample = arSamples[lIndex];
+
+		//Bias and noise are already in the recording
+		if(lrSample.mTime * 1000UL > Shim::Now())
+		{
+			Shim::Spend(lrSample.mTime * 1000UL - Shim::Now());
+		}
+		for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+		{
+			Wire.mMpu.mRate[lAxis] = lrSample.mGyro[lAxis];
+		}
+
+		if(lrSample.mTime < aWarmupMs)
+		{
+			if(aCalibrate)
+			{
+				lCalibrator.Update();
+			}
+			continue;
+		}
+
+		//Offset units are 1000 deg/s range, 32.8 per deg/s
+		float lSpeed = lCalibrator.ReadSpeed() / 32.8f;
+		for(uint8_t lLevel = 0; lLevel < 3; lLevel++)
+		{
+			CountTrigger(lSwing[lLevel], lSpeed > lThresholds[lLevel], lrSample.mTime);
+		}
+
+		float lAccel = sqrtf(lrSample.mAccel[0] * lrSample.mAccel[0] +
+							 lrSample.mAccel[1] * lrSample.mAccel[1] +
+							 lrSample.mAccel[2] * lrSample.mAccel[2]);
+		if(lLastAccel >= 0)
+		{
+			CountTrigger(lClash, fabsf(lAccel - lLastAccel) * 100.0f > lProfile.mClash, lrSample.mTime);
+		}
+		lLastAccel = lAccel;
+
+		if(0 == lMeasured)
+		{
+			lStart = lrSample.mTime;
+		}
+		lEnd = lrSample.mTime;
+		lMeasured++;
+	}
+
+	float lMinutes = max(lEnd - lStart, 1UL) / 60000.0f;
+	const int16_t* lpOffsets = lCalibrator.GetOffsets();
+
+	printf("%-12s %8lu %7.1f %7lu %7lu %7lu %7lu %9.1f   %d,%d,%d\n",
+		   aCalibrate ? "calibrated" : "raw", lMeasured, lMinutes * 60.0f,
+		   lSwing[0].mCount, lSwing[1].mCount, lSwing[2].mCount, lClash.mCount,
+		   lSwing[1].mCount / lMinutes, lpOffsets[0], lpOffsets[1], lpOffsets[2]);
+}
+
+int main(int aArgc, char** aArgv)
+{
+	std::vector<ReplaySample> lSamples;
+	unsigned long lWarmupMs = ((aArgc > 2) ? atof(aArgv[2]) : REPLAY_DEFAULT_WARMUP_S) * 1000UL;
+
+	if(aArgc > 1)
+	{
+		if(!LoadTrace(aArgv[1], lSamples))
+		{
+			printf("No samples in %s\n", aArgv[1]);
+			return 1;
+		}
+		printf("trace: %s, %u samples, %lu s warm-up\n", aArgv[1], (unsigned int)lSamples.size(), lWarmupMs / 1000);
+	}
+	else
+	{
+		MakeTrace(lWarmupMs, lSamples);
+		printf("trace: synthetic, bias %.0f/%.0f/%.0f deg/s, %lu s still then held, %d s total\n",
+			   sSynthBias[0], sSynthBias[1], sSynthBias[2], lWarmupMs / 1000, SYNTH_LENGTH_S);
+	}
+
+	printf("%-12s %8s %7s %7s %7s %7s %7s %9s   %s\n", "run", "samples", "seconds",
+		   "swing-s", "swing-m", "swing-l", "clash", "clips/min", "offsets");
+	Replay(lSamples, lWarmupMs, false);
+	Replay(lSamples, lWarmupMs, true);
+
+	return 0;
+}
@@ -0,0 +1,317 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * SaberHarness.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "SaberHarness.h"
+
+//A clash keeps the motion flag up while the blade rings
+#define HARNESS_CLASH_RING_MS 20
+
+//Long enough for every timed state to run out once the inputs go quiet
+#define HARNESS_SETTLE_MS 4000
+
+//Hold that powers the saber down, and time to finish the ramp after it
+#define HARNESS_POWER_DOWN_HOLD_MS 1600
+#define HARNESS_POWER_DOWN_MS 1500
+
+SaberHarness::SaberHarness() :
+mSound(0, 0, 0),
+mBlade(0, 0, 0),
+mMotion(&mToleranceData),
+mActButton(HARNESS_ACT_PIN),
+mAuxButton(HARNESS_AUX_PIN),
+mpSaber(0),
+mCycles(0),
+mMaxCycleUs(0),
+mStepIndex(-1),
+mTraceEndState(eeBoot),
+mResult(eeHarnessPass),
+mClashEndUs(0)
+{
+	memset(&mToleranceData, 0, sizeof(mToleranceData));
+	mFailure[0] = '\0';
+}
+
+SaberHarness::~SaberHarness()
+{
+	delete mpSaber;
+}
+
+void SaberHarness::PowerOn(const HarnessConfig& arConfig, bool aKeepEeprom)
+{
+	Shim::Reset();
+	Wire.mMpu.Reset();
+	if(!aKeepEeprom)
+	{
+		EEPROM.Erase();
+	}
+	mSound.Reset();
+	mBlade.Reset();
+	mMotion.Reset();
+
+	for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+	{
+		Wire.mMpu.mBias[lAxis] = arConfig.mGyroBias[lAxis];
+	}
+	Wire.mMpu.mNoise = arConfig.mGyroNoise;
+	Wire.mMpu.mPresent = arConfig.mMpuPresent;
+
+	//Buttons start released (pins are pulled up by Button::Init())
+	delete mpSaber;
+	mActButton = Button(HARNESS_ACT_PIN);
+	mAuxButton = Button(HARNESS_AUX_PIN);
+	mpSaber = new SaberStateMachine(&mSound, &mMotion, &mBlade,
+									&mActButton, &mAuxButton, &mToleranceData);
+	mpSaber->Init();
+
+	//Waits during Init() are fine, only count the ones inside Operate()
+	Shim::gDelayCalls = 0;
+
+	mCycles = 0;
+	mMaxCycleUs = 0;
+	mStepIndex = -1;
+	mResult = eeHarnessPass;
+	mFailure[0] = '\0';
+	mClashEndUs = 0;
+}
+
+bool SaberHarness::Cycle()
+{
+	mMotion.mScriptClash = (Shim::Now() < mClashEndUs);
+
+	unsigned long lStart = Shim::Now();
+	unsigned long lDelays = Shim::gDelayCalls;
+	unsigned long lReads = Shim::gClockReads;
+
+	mpSaber->Operate();
+	mCycles++;
+
+	unsigned long lElapsed = Shim::Now() - lStart;
+	mMaxCycleUs = max(mMaxCycleUs, lElapsed);
+
+	if(Shim::gDelayCalls != lDelays)
+	{
+		Fail(eeHarnessBlocked, "delay() called in state %d", GetState());
+	}
+	else if(Shim::gClockReads - lReads > HARNESS_MAX_CLOCK_READS)
+	{
+		Fail(eeHarnessPolling, "%lu clock reads in one cycle in state %d",
+			 Shim::gClockReads - lReads, GetState());
+	}
+	else if(lElapsed > HARNESS_CYCLE_BUDGET_MS * 1000UL)
+	{
+		Fail(eeHarnessSlowCycle, "cycle took %lu us in state %d", lElapsed, GetState());
+	}
+	else if(GetState() < eeBoot || GetState() >= eeMenu)
+	{
+		//eeMenu has no way out yet, so reaching it is a failure too
+		Fail(eeHarnessBadState, "entered state %d", GetState());
+	}
+
+	return (eeHarnessPass == mResult);
+}
+
+bool SaberHarness::RunFor(unsigned long aMs)
+{
+	unsigned long lEnd = Shim::Now() + aMs * 1000UL;
+
+	while(Shim::Now() < lEnd && Cycle())
+	{
+		//Keep cycling
+	}
+
+	return (eeHarnessPass == mResult);
+}
+
+void SaberHarness::ApplyInputs(const HarnessStep& arStep)
+{
+	Shim::SetPin(HARNESS_ACT_PIN, arStep.mActHeld ? LOW : HIGH);
+	Shim::SetPin(HARNESS_AUX_PIN, arStep.mAuxHeld ? LOW : HIGH);
+
+	if(arStep.mClash)
+	{
+		mClashEndUs = Shim::Now() + HARNESS_CLASH_RING_MS * 1000UL;
+	}
+
+	mMotion.mScriptSwing = (ESwingMagnitude)arStep.mSwing;
+
+	//The gyro sees the swing too, it drives the hum volume
+	float lRate = 0;
+	switch(arStep.mSwing)
+	{
+	case eeSmall:
+		lRate = HARNESS_SWING_RATE_SMALL;
+		break;
+	case eeMedium:
+		lRate = HARNESS_SWING_RATE_MEDIUM;
+		break;
+	case eeLarge:
+		lRate = HARNESS_SWING_RATE_LARGE;
+		break;
+	default:
+		//No swing
+		break;
+	}
+	Wire.mMpu.mRate[1] = lRate;
+}
+
+bool SaberHarness::RunStep(const HarnessStep& arStep)
+{
+	ApplyInputs(arStep);
+	return RunFor(arStep.mDuration);
+}
+
+bool SaberHarness::RecoverToOff()
+{
+	HarnessStep lQuiet = { 0, false, false, false, eeNone };
+	HarnessStep lHold = { 0, true, false, false, eeNone };
+
+	ApplyInputs(lQuiet);
+	RunFor(HARNESS_SETTLE_MS);
+
+	if(eeHarnessPass == mResult && IsPoweredState(GetState()))
+	{
+		ApplyInputs(lHold);
+		RunFor(HARNESS_POWER_DOWN_HOLD_MS);
+		ApplyInputs(lQuiet);
+		RunFor(HARNESS_POWER_DOWN_MS);
+	}
+
+	if(eeHarnessPass == mResult && eeOff != GetState())
+	{
+		Fail(eeHarnessStuck, "state %d after recovery", GetState());
+	}
+
+	return (eeHarnessPass == mResult);
+}
+
+EHarnessResult SaberHarness::RunTrace(const HarnessConfig& arConfig, const std::vector<HarnessStep>& arTrace)
+{
+	PowerOn(arConfig);
+
+	for(size_t lIndex = 0; lIndex < arTrace.size() && eeHarnessPass == mResult; lIndex++)
+	{
+		mStepIndex = lIndex;
+		RunStep(arTrace[lIndex]);
+	}
+
+	if(eeHarnessPass == mResult)
+	{
+		mStepIndex = -1;
+		mTraceEndState = GetState();
+		RecoverToOff();
+	}
+
+	return mResult;
+}
+
+int SaberHarness::GetState()
+{
+	return mpSaber->GetState();
+}
+
+bool SaberHarness::IsPoweredState(int aState)
+{
+	return (aState >= eePoweringUp && aState <= eePoweringDown);
+}
+
+EHarnessResult SaberHarness::GetResult()
+{
+	return mResult;
+}
+
+const char* SaberHarness::GetFailure()
+{
+	return mFailure;
+}
+
+const char* SaberHarness::ResultName(EHarnessResult aResult)
+{
+	const char* lpName = "unknown";
+
+	switch(aResult)
+	{
+	case eeHarnessPass:
+		lpName = "pass";
+		break;
+	case eeHarnessSlowCycle:
+		lpName = "slow cycle";
+		break;
+	case eeHarnessBlocked:
+		lpName = "blocking wait";
+		break;
+	case eeHarnessPolling:
+		lpName = "polling";
+		break;
+	case eeHarnessBadState:
+		lpName = "bad state";
+		break;
+	case eeHarnessStuck:
+		lpName = "stuck";
+		break;
+	}
+
+	return lpName;
+}
+
+void SaberHarness::PrintTrace(const HarnessConfig& arConfig, const std::vector<HarnessStep>& arTrace)
+{
+	printf("\tconst HarnessConfig lConfig = { { %.2ff, %.2ff, %.2ff }, %.2ff, %s };\n",
+		   arConfig.mGyroBias[0], arConfig.mGyroBias[1], arConfig.mGyroBias[2],
+		   arConfig.mGyroNoise, arConfig.mMpuPresent ? "true" : "false");
+	printf("\tconst HarnessStep lSteps[] =\n\t{\n");
+	printf("\t\t//Duration, act, aux, clash, swing\n");
+	for(size_t lIndex = 0; lIndex < arTrace.size(); lIndex++)
+	{
+		const HarnessStep& lrStep = arTrace[lIndex];
+		printf("\t\t{ %u, %s, %s, %s, %u },\n", lrStep.mDuration,
+			   lrStep.mActHeld ? "true" : "false",
+			   lrStep.mAuxHeld ? "true" : "false",
+			   lrStep.mClash ? "true" : "false",
+			   lrStep.mSwing);
+	}
+	printf("\t};\n");
+}
+
+HarnessConfig SaberHarness::DefaultConfig()
+{
+	HarnessConfig lConfig = { { 0, 0, 0 }, 0, true };
+	return lConfig;
+}
+
+void SaberHarness::Fail(EHarnessResult aResult, const char* apFormat, ...)
+{
+	if(eeHarnessPass == mResult)
+	{
+		char lDetail[120];
+		va_list lArgs;
+		va_start(lArgs, apFormat);
+		vsnprintf(lDetail, sizeof(lDetail), apFormat, lArgs);
+		va_end(lArgs);
+
+		mResult = aResult;
+		snprintf(mFailure, sizeof(mFailure), "%s at %lu ms (step %d): %s",
+				 ResultName(aResult), Shim::Now() / 1000, mStepIndex, lDetail);
+	}
+}
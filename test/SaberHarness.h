@@ -0,0 +1,242 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * SaberHarness.h
+ *   Runs SaberStateMachine on the host against the shims in test/shims,
+ *   driving its inputs from a trace of steps and checking invariants on
+ *   every Operate() cycle.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef SABERHARNESS_H_
+#define SABERHARNESS_H_
+
+#include <vector>
+#include <Arduino.h>
+#include <USaber.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include "../SaberStateMachine.h"
+#include "../Button.h"
+
+//Longest an Operate() cycle may take. Same bound that
+//SaberStateMachine::CheckCycleTime() reports against.
+#define HARNESS_CYCLE_BUDGET_MS 25
+
+//More clock reads than this in one cycle means something is polling
+#define HARNESS_MAX_CLOCK_READS 200
+
+//Pins the harness presses the buttons on
+#define HARNESS_ACT_PIN 12
+#define HARNESS_AUX_PIN 4
+
+//Gyro rate that goes with each swing magnitude (deg/s)
+#define HARNESS_SWING_RATE_SMALL 60
+#define HARNESS_SWING_RATE_MEDIUM 200
+#define HARNESS_SWING_RATE_LARGE 500
+
+/**
+ * What the outside world does for a while.
+ */
+struct HarnessStep
+{
+	uint16_t mDuration; //How long the step lasts (ms)
+	bool mActHeld; //Activation button held down
+	bool mAuxHeld; //Auxiliary button held down
+	bool mClash; //Impact at the start of the step
+	uint8_t mSwing; //Swing magnitude for the whole step (ESwingMagnitude)
+};
+
+/**
+ * Trace-wide conditions that don't change from step to step.
+ */
+struct HarnessConfig
+{
+	float mGyroBias[3]; //Zero-rate bias of the gyro (deg/s)
+	float mGyroNoise; //Peak gyro noise (deg/s)
+	bool mMpuPresent; //FALSE simulates a sensor that doesn't answer
+};
+
+/**
+ * Result of running a trace.
+ */
+enum EHarnessResult
+{
+	eeHarnessPass,
+	eeHarnessSlowCycle, //Operate() took longer than the cycle budget
+	eeHarnessBlocked, //Operate() called delay()
+	eeHarnessPolling, //Operate() kept reading the clock
+	eeHarnessBadState, //Saber reached a state it can't leave
+	eeHarnessStuck //Saber could not be brought back to eeOff
+};
+
+/**
+ * Host test bench for SaberStateMachine.
+ */
+class SaberHarness
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	SaberHarness();
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~SaberHarness();
+
+	/**
+	 * Power the saber up from scratch and run SaberStateMachine::Init().
+	 * Args:
+	 *   arConfig - Trace-wide conditions
+	 *   aKeepEeprom - TRUE to keep what was saved before, FALSE for a
+	 *                 blank part
+	 */
+	void PowerOn(const HarnessConfig& arConfig, bool aKeepEeprom = false);
+
+	/**
+	 * Run one Operate() cycle and check the per-cycle invariants.
+	 * Returns:
+	 *   TRUE if the invariants held, FALSE otherwise (see GetResult()).
+	 */
+	bool Cycle();
+
+	/**
+	 * Run cycles until some time has passed.
+	 * Args:
+	 *   aMs - Time to run for (ms)
+	 * Returns:
+	 *   TRUE if the invariants held, FALSE otherwise.
+	 */
+	bool RunFor(unsigned long aMs);
+
+	/**
+	 * Set the inputs for a step and run it.
+	 * Args:
+	 *   arStep - Step to run
+	 * Returns:
+	 *   TRUE if the invariants held, FALSE otherwise.
+	 */
+	bool RunStep(const HarnessStep& arStep);
+
+	/**
+	 * Set the inputs for a step without running any cycles.
+	 * Args:
+	 *   arStep - Step to apply
+	 */
+	void ApplyInputs(const HarnessStep& arStep);
+
+	/**
+	 * Let go of everything, then turn the saber off the way a user would.
+	 * Returns:
+	 *   TRUE if the saber ended up in eeOff, FALSE otherwise.
+	 */
+	bool RecoverToOff();
+
+	/**
+	 * Power on, run a whole trace and check it can be recovered to eeOff.
+	 * Args:
+	 *   arConfig - Trace-wide conditions
+	 *   arTrace - Steps to run
+	 * Returns:
+	 *   Outcome of the run.
+	 */
+	EHarnessResult RunTrace(const HarnessConfig& arConfig, const std::vector<HarnessStep>& arTrace);
+
+	/**
+	 * Get the saber's current state.
+	 * Returns:
+	 *   ESaberState value
+	 */
+	int GetState();
+
+	/**
+	 * Is the state one where the blade is (or is getting) powered?
+	 * Args:
+	 *   aState - ESaberState value
+	 * Returns:
+	 *   TRUE for powered states, FALSE otherwise.
+	 */
+	static bool IsPoweredState(int aState);
+
+	/**
+	 * Get the result of the first invariant that failed.
+	 * Returns:
+	 *   eeHarnessPass if none failed.
+	 */
+	EHarnessResult GetResult();
+
+	/**
+	 * Describe the failure, if any.
+	 * Returns:
+	 *   Text describing the first failure.
+	 */
+	const char* GetFailure();
+
+	/**
+	 * Name of a result.
+	 * Args:
+	 *   aResult - EHarnessResult value
+	 * Returns:
+	 *   Name of the result
+	 */
+	static const char* ResultName(EHarnessResult aResult);
+
+	/**
+	 * Print a trace as C++ that can be pasted into a scenario test.
+	 * Args:
+	 *   arConfig - Trace-wide conditions
+	 *   arTrace - Steps to print
+	 */
+	static void PrintTrace(const HarnessConfig& arConfig, const std::vector<HarnessStep>& arTrace);
+
+	/**
+	 * Default conditions: a quiet, present, unbiased gyro.
+	 * Returns:
+	 *   The default configuration.
+	 */
+	static HarnessConfig DefaultConfig();
+
+	//Parts the saber is built from, for scenarios to inspect
+	DIYinoSoundPlayer mSound;
+	RGBBlade mBlade;
+	Mpu6050LiteMotionManager mMotion;
+	MPU6050LiteTolData mToleranceData;
+	Button mActButton;
+	Button mAuxButton;
+	SaberStateMachine* mpSaber;
+
+	unsigned long mCycles; //Operate() cycles since PowerOn()
+	unsigned long mMaxCycleUs; //Slowest cycle since PowerOn()
+	int mStepIndex; //Step of the trace being run (-1 outside a trace)
+	int mTraceEndState; //State the last trace left the saber in before recovery
+
+private:
+	/**
+	 * Record the first failure.
+	 */
+	void Fail(EHarnessResult aResult, const char* apFormat, ...);
+
+	EHarnessResult mResult;
+	char mFailure[200];
+	unsigned long mClashEndUs; //Clash input stays asserted until this time
+};
+
+#endif /* SABERHARNESS_H_ */
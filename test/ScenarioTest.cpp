@@ -0,0 +1,436 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * ScenarioTest.cpp
+ *   Scripted scenarios for the blade effects of SaberStateMachine: how
+ *   quickly a press or impact shows on the blade, impacts during lockup
+ *   and repeated blaster deflects. Also how often the hum volume is sent
+ *   to the sound module and switching profiles.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include "SaberHarness.h"
+#include "Profiles.h"
+
+//An impact is seen by the motion update at the start of a cycle, handled
+//in that cycle and shown by the entry action of the next one
+#define IMPACT_FLASH_CYCLES 2
+
+//A button needs one more cycle than an impact before it reads as held
+#define PRESS_FLASH_CYCLES 3
+
+//Same timings as SaberStateMachine
+#define SWITCH_DEBOUCE_TIME 50
+#define CLASH_SETTLE_TIME 200
+#define LOCKUP_HOLD_TIME 300
+#define BLASTER_FLASH_TIME 80
+#define HUM_UPDATE_INTERVAL 50
+#define PROFILE_SWITCH_TIMEOUT 3000
+
+//Fast enough back-and-forth swinging that every hum update sees a change
+#define SWING_TOGGLE_TIME 20
+
+#define CHECK(aCondition) Check((aCondition), #aCondition, __LINE__)
+
+static unsigned int sChecks = 0;
+static unsigned int sFailures = 0;
+
+/**
+ * Record the outcome of a check and report it if it failed.
+ */
+static void Check(bool aPassed, const char* apText, int aLine)
+{
+	sChecks++;
+	if(!aPassed)
+	{
+		sFailures++;
+		printf("  FAIL line %d: %s\n", aLine, apText);
+	}
+}
+
+//Inputs used by the scenarios
+static const HarnessStep sQuiet = { 0, false, false, false, eeNone };
+static const HarnessStep sActDown = { 0, true, false, false, eeNone };
+static const HarnessStep sAuxDown = { 0, false, true, false, eeNone };
+static const HarnessStep sImpact = { 0, false, false, true, eeNone };
+static const HarnessStep sAuxImpact = { 0, false, true, true, eeNone };
+
+/**
+ * Boot the saber and turn the blade on.
+ */
+static void PowerUp(SaberHarness& arHarness)
+{
+	arHarness.PowerOn(SaberHarness::DefaultConfig());
+	arHarness.RunFor(300);
+
+	arHarness.ApplyInputs(sActDown);
+	arHarness.RunFor(80);
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(1200);
+}
+
+/**
+ * Run cycles until the blade shows the profile's flash color.
+ * Args:
+ *   arHarness - Harness to run
+ *   aMaxCycles - Give up after this many cycles
+ * Returns:
+ *   Cycles it took, or aMaxCycles + 1 if the flash didn't show.
+ */
+static unsigned int CyclesToFlash(SaberHarness& arHarness, unsigned int aMaxCycles)
+{
+	SaberProfile lProfile;
+	memcpy_P(&lProfile, &gProfiles[0], sizeof(SaberProfile));
+
+	unsigned int lCycles = 0;
+	bool lFlashed = false;
+	while(!lFlashed && lCycles <= aMaxCycles)
+	{
+		arHarness.Cycle();
+		lCycles++;
+		lFlashed = arHarness.mBlade.IsShowing(lProfile.mFlashColor);
+	}
+
+	return lCycles;
+}
+
+/**
+ * Is the blade showing the profile's base color?
+ */
+static bool IsShowingBase(SaberHarness& arHarness)
+{
+	SaberProfile lProfile;
+	memcpy_P(&lProfile, &gProfiles[0], sizeof(SaberProfile));
+	return arHarness.mBlade.IsShowing(lProfile.mBladeColor);
+}
+
+/**
+ * How many times a sound has been started.
+ */
+static unsigned long Played(SaberHarness& arHarness, ESoundTypes aType)
+{
+	return arHarness.mSound.mPlayed[(int)aType];
+}
+
+static void TestImpactFlash(SaberHarness& arHarness)
+{
+	PowerUp(arHarness);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(IsShowingBase(arHarness));
+
+	arHarness.ApplyInputs(sImpact);
+	CHECK(CyclesToFlash(arHarness, IMPACT_FLASH_CYCLES) <= IMPACT_FLASH_CYCLES);
+	CHECK(eeClash == arHarness.GetState());
+	CHECK(1 == Played(arHarness, ESoundTypes::eeClashSnd));
+
+	//Back to the base color once the clash settles
+	arHarness.RunFor(1500);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(IsShowingBase(arHarness));
+}
+
+static void TestPressFlash(SaberHarness& arHarness)
+{
+	PowerUp(arHarness);
+
+	arHarness.ApplyInputs(sAuxDown);
+	CHECK(CyclesToFlash(arHarness, PRESS_FLASH_CYCLES) <= PRESS_FLASH_CYCLES);
+	CHECK(eeBlaster == arHarness.GetState());
+	CHECK(1 == Played(arHarness, ESoundTypes::eeBlasterSnd));
+
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(200);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(IsShowingBase(arHarness));
+}
+
+static void TestLockupImpacts(SaberHarness& arHarness)
+{
+	PowerUp(arHarness);
+
+	//Holding the auxiliary button deflects, then locks up
+	arHarness.ApplyInputs(sAuxDown);
+	arHarness.RunFor(LOCKUP_HOLD_TIME + 200);
+	CHECK(eeLockup == arHarness.GetState());
+	unsigned long lLockupSounds = Played(arHarness, ESoundTypes::eeLockupSnd);
+	CHECK(1 == lLockupSounds);
+
+	//Each impact flares the blade and restarts the lockup sound
+	for(uint8_t lImpact = 0; lImpact < 3; lImpact++)
+	{
+		arHarness.ApplyInputs(sAuxImpact);
+		arHarness.Cycle();
+		CHECK(eeLockup == arHarness.GetState());
+		CHECK(eeLockupFlare == arHarness.mpSaber->GetSubState());
+		CHECK(CyclesToFlash(arHarness, IMPACT_FLASH_CYCLES) <= IMPACT_FLASH_CYCLES);
+		CHECK(++lLockupSounds == Played(arHarness, ESoundTypes::eeLockupSnd));
+
+		arHarness.RunFor(CLASH_SETTLE_TIME + 50);
+		CHECK(eeLockup == arHarness.GetState());
+	}
+
+	//Impacts closer together than the settle time count once
+	arHarness.ApplyInputs(sAuxImpact);
+	arHarness.RunFor(CLASH_SETTLE_TIME / 2);
+	arHarness.ApplyInputs(sAuxImpact);
+	arHarness.RunFor(CLASH_SETTLE_TIME / 2 - 10);
+	CHECK(++lLockupSounds == Played(arHarness, ESoundTypes::eeLockupSnd));
+
+	//No clash effect plays on top of the lockup
+	CHECK(0 == Played(arHarness, ESoundTypes::eeClashSnd));
+
+	//Held without impacts, the lockup sound relaunches as the profile's clip ends
+	arHarness.ApplyInputs(sAuxDown);
+	arHarness.RunFor(gProfiles[0].mLockupLength - 200);
+	CHECK(lLockupSounds == Played(arHarness, ESoundTypes::eeLockupSnd));
+	arHarness.RunFor(250);
+	CHECK(++lLockupSounds == Played(arHarness, ESoundTypes::eeLockupSnd));
+	CHECK(eeLockup == arHarness.GetState());
+
+	//Letting go ends the lockup
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(100);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(IsShowingBase(arHarness));
+}
+
+static void TestRepeatedBlaster(SaberHarness& arHarness)
+{
+	PowerUp(arHarness);
+
+	//Presses spaced out so each flash finishes first
+	for(uint8_t lPress = 1; lPress <= 5; lPress++)
+	{
+		arHarness.ApplyInputs(sAuxDown);
+		CHECK(CyclesToFlash(arHarness, PRESS_FLASH_CYCLES) <= PRESS_FLASH_CYCLES);
+		CHECK(lPress == Played(arHarness, ESoundTypes::eeBlasterSnd));
+		arHarness.RunFor(60);
+		arHarness.ApplyInputs(sQuiet);
+		arHarness.RunFor(150);
+		CHECK(eeOnIdle == arHarness.GetState());
+		CHECK(IsShowingBase(arHarness));
+	}
+
+	//Presses faster than the flash deflect again without going idle, as
+	//long as the button is let go for longer than the debounce time
+	for(uint8_t lPress = 6; lPress <= 10; lPress++)
+	{
+		arHarness.ApplyInputs(sAuxDown);
+		arHarness.RunFor(BLASTER_FLASH_TIME / 4);
+		CHECK(eeBlaster == arHarness.GetState());
+		CHECK(lPress == Played(arHarness, ESoundTypes::eeBlasterSnd));
+		arHarness.ApplyInputs(sQuiet);
+		arHarness.RunFor(SWITCH_DEBOUCE_TIME + 5);
+	}
+
+	//None of the presses were long enough to lock up
+	arHarness.RunFor(200);
+	CHECK(0 == Played(arHarness, ESoundTypes::eeLockupSnd));
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(IsShowingBase(arHarness));
+}
+
+static void TestBouncingPress(SaberHarness& arHarness)
+{
+	SaberProfile lProfile;
+	memcpy_P(&lProfile, &gProfiles[0], sizeof(SaberProfile));
+
+	PowerUp(arHarness);
+
+	//One physical press whose contacts bounce open for a moment
+	const HarnessStep lBounce[] =
+	{
+		{ 10, false, true, false, eeNone },
+		{ 4, false, false, false, eeNone },
+		{ 60, false, true, false, eeNone },
+		{ 200, false, false, false, eeNone }
+	};
+
+	unsigned int lFlashes = 0;
+	bool lWasFlash = false;
+	for(uint8_t lStep = 0; lStep < sizeof(lBounce) / sizeof(lBounce[0]); lStep++)
+	{
+		arHarness.ApplyInputs(lBounce[lStep]);
+		unsigned long lEnd = Shim::Now() + lBounce[lStep].mDuration * 1000UL;
+		while(Shim::Now() < lEnd && arHarness.Cycle())
+		{
+			bool lFlash = arHarness.mBlade.IsShowing(lProfile.mFlashColor);
+			lFlashes += (lFlash && !lWasFlash) ? 1 : 0;
+			lWasFlash = lFlash;
+		}
+	}
+
+	CHECK(1 == Played(arHarness, ESoundTypes::eeBlasterSnd));
+	CHECK(1 == lFlashes);
+	CHECK(eeOnIdle == arHarness.GetState());
+}
+
+static void TestHumVolumeRate(SaberHarness& arHarness)
+{
+	SaberProfile lProfile;
+	memcpy_P(&lProfile, &gProfiles[0], sizeof(SaberProfile));
+
+	//A noisy, biased gyro at rest is still at rest once calibrated
+	HarnessConfig lConfig = { { 1.5f, -2.0f, 0.5f }, 1.0f, true };
+	arHarness.PowerOn(lConfig);
+	arHarness.RunFor(300);
+	arHarness.ApplyInputs(sActDown);
+	arHarness.RunFor(80);
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(3000);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(lProfile.mVolume == arHarness.mSound.mVolume);
+
+	//Nothing is sent to the sound module while the saber is still
+	unsigned long lCommands = arHarness.mSound.mCommands;
+	arHarness.RunFor(10000);
+	CHECK(lCommands == arHarness.mSound.mCommands);
+
+	//Swinging back and forth faster than the hum updates, the volume
+	//follows but never takes more than 20 commands in any second
+	const HarnessStep lSwing = { 0, false, false, false, eeLarge };
+	unsigned long lTotal = 0;
+	for(uint8_t lSecond = 0; lSecond < 10; lSecond++)
+	{
+		unsigned long lVolumeCommands = arHarness.mSound.mVolumeCommands;
+		for(uint8_t lStep = 0; lStep < 1000 / SWING_TOGGLE_TIME; lStep++)
+		{
+			arHarness.ApplyInputs((lStep & 1) ? sQuiet : lSwing);
+			arHarness.RunFor(SWING_TOGGLE_TIME);
+		}
+		lVolumeCommands = arHarness.mSound.mVolumeCommands - lVolumeCommands;
+		CHECK(lVolumeCommands <= 1000 / HUM_UPDATE_INTERVAL);
+		lTotal += lVolumeCommands;
+	}
+	CHECK(lTotal > 0);
+
+	//Once the swinging stops the volume settles back to the profile's
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(1000);
+	CHECK(eeOnIdle == arHarness.GetState());
+	CHECK(lProfile.mVolume == arHarness.mSound.mVolume);
+	lCommands = arHarness.mSound.mVolumeCommands;
+	arHarness.RunFor(5000);
+	CHECK(lCommands == arHarness.mSound.mVolumeCommands);
+}
+
+/**
+ * Press and release a button for long enough to count as a tap.
+ */
+static void Tap(SaberHarness& arHarness, const HarnessStep& arDown)
+{
+	arHarness.ApplyInputs(arDown);
+	arHarness.RunFor(100);
+	arHarness.ApplyInputs(sQuiet);
+	arHarness.RunFor(100);
+}
+
+/**
+ * Boot again with the EEPROM as it was left and get the profile's font.
+ */
+static uint8_t RebootFont(SaberHarness& arHarness)
+{
+	arHarness.PowerOn(SaberHarness::DefaultConfig(), true);
+	return arHarness.mSound.mFont;
+}
+
+static void TestProfileSwitch(SaberHarness& arHarness)
+{
+	arHarness.PowerOn(SaberHarness::DefaultConfig());
+	arHarness.RunFor(1500);
+	CHECK(eeOff == arHarness.GetState());
+	CHECK(pgm_read_byte(&gProfiles[0].mFont) == arHarness.mSound.mFont);
+	unsigned long lWrites = EEPROM.mWrites;
+
+	//Each aux tap moves to the next profile and plays its font ID,
+	//wrapping around after the last one
+	for(uint8_t lTap = 1; lTap <= NUM_PROFILES + 1; lTap++)
+	{
+		Tap(arHarness, sAuxDown);
+		CHECK(eeSwitchProfile == arHarness.GetState());
+		CHECK(pgm_read_byte(&gProfiles[lTap % NUM_PROFILES].mFont) == arHarness.mSound.mFont);
+		CHECK(lTap == Played(arHarness, ESoundTypes::eeFontIdSnd));
+	}
+
+	//Nothing is saved until the selection is confirmed by a pause
+	arHarness.RunFor(PROFILE_SWITCH_TIMEOUT - 500);
+	CHECK(eeSwitchProfile == arHarness.GetState());
+	CHECK(lWrites == EEPROM.mWrites);
+	arHarness.RunFor(1000);
+	CHECK(eeOff == arHarness.GetState());
+	arHarness.RunFor(500);
+	CHECK(lWrites != EEPROM.mWrites);
+	CHECK(pgm_read_byte(&gProfiles[1].mFont) == RebootFont(arHarness));
+
+	//The activation button confirms without waiting
+	arHarness.RunFor(1500);
+	lWrites = EEPROM.mWrites;
+	Tap(arHarness, sAuxDown);
+	CHECK(lWrites == EEPROM.mWrites);
+	Tap(arHarness, sActDown);
+	CHECK(eeOff == arHarness.GetState());
+	arHarness.RunFor(500);
+	CHECK(lWrites != EEPROM.mWrites);
+	CHECK(pgm_read_byte(&gProfiles[2].mFont) == RebootFont(arHarness));
+
+	//Cycling back round to the saved profile doesn't write anything
+	arHarness.RunFor(1500);
+	lWrites = EEPROM.mWrites;
+	for(uint8_t lTap = 0; lTap < NUM_PROFILES; lTap++)
+	{
+		Tap(arHarness, sAuxDown);
+	}
+	arHarness.RunFor(PROFILE_SWITCH_TIMEOUT + 500);
+	CHECK(eeOff == arHarness.GetState());
+	CHECK(lWrites == EEPROM.mWrites);
+}
+
+/**
+ * Run one scenario on a fresh harness and check the cycle invariants held.
+ */
+static void Run(const char* apName, void (*apScenario)(SaberHarness&))
+{
+	SaberHarness lHarness;
+	unsigned int lFailures = sFailures;
+
+	apScenario(lHarness);
+	CHECK(eeHarnessPass == lHarness.GetResult());
+	if(eeHarnessPass != lHarness.GetResult())
+	{
+		printf("  %s\n", lHarness.GetFailure());
+	}
+
+	printf("%s %s\n", (lFailures == sFailures) ? "pass" : "FAIL", apName);
+}
+
+int main()
+{
+	Run("impact flashes within 2 cycles", TestImpactFlash);
+	Run("press flashes within 3 cycles", TestPressFlash);
+	Run("impacts during lockup", TestLockupImpacts);
+	Run("repeated blaster presses", TestRepeatedBlaster);
+	Run("bouncing press deflects once", TestBouncingPress);
+	Run("hum volume rate", TestHumVolumeRate);
+	Run("profile switching", TestProfileSwitch);
+
+	printf("scenarios: %u checks, %u failed\n", sChecks, sFailures);
+
+	return (0 == sFailures) ? 0 : 1;
+}
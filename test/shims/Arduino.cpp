@@ -0,0 +1,226 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Arduino.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+
+//Reading the clock isn't free on the target either. Charging for it also
+//lets a busy-wait on millis() finish, so it shows up as a slow cycle
+//instead of hanging the harness.
+#define CLOCK_READ_COST_US 1
+
+//Power-on seed of the random() generator
+#define RANDOM_DEFAULT_SEED 1
+
+HardwareSerial Serial;
+
+unsigned long Shim::gDelayCalls = 0;
+unsigned long Shim::gClockReads = 0;
+
+static unsigned long sNowUs = 0;
+static uint8_t sPinLevels[NUM_PINS];
+static unsigned long sRandomState = RANDOM_DEFAULT_SEED;
+
+unsigned long millis()
+{
+	Shim::gClockReads++;
+	Shim::Spend(CLOCK_READ_COST_US);
+	return sNowUs / 1000;
+}
+
+unsigned long micros()
+{
+	Shim::gClockReads++;
+	Shim::Spend(CLOCK_READ_COST_US);
+	return sNowUs;
+}
+
+void delay(unsigned long aMs)
+{
+	Shim::gDelayCalls++;
+	Shim::Spend(aMs * 1000);
+}
+
+void delayMicroseconds(unsigned int aUs)
+{
+	Shim::gDelayCalls++;
+	Shim::Spend(aUs);
+}
+
+void pinMode(uint8_t /*aPin*/, uint8_t /*aMode*/)
+{
+	//Do nothing
+}
+
+void digitalWrite(uint8_t aPin, uint8_t aLevel)
+{
+	//Writing HIGH to an input turns on the pull-up, which is how the
+	//buttons read when they aren't pressed
+	if(aPin < NUM_PINS)
+	{
+		sPinLevels[aPin] = aLevel;
+	}
+}
+
+int digitalRead(uint8_t aPin)
+{
+	return (aPin < NUM_PINS) ? sPinLevels[aPin] : LOW;
+}
+
+void analogWrite(uint8_t /*aPin*/, int /*aValue*/)
+{
+	//Do nothing
+}
+
+void randomSeed(unsigned long aSeed)
+{
+	sRandomState = (0 == aSeed) ? RANDOM_DEFAULT_SEED : aSeed;
+}
+
+long random(long aMax)
+{
+	//Same recurrence as avr-libc's random(), so sequences are repeatable
+	long lHi = sRandomState / 127773L;
+	long lLo = sRandomState % 127773L;
+	long lNext = 16807L * lLo - 2836L * lHi;
+	if(lNext < 0)
+	{
+		lNext += 0x7FFFFFFFL;
+	}
+	sRandomState = lNext;
+
+	return (aMax > 0) ? (lNext % aMax) : 0;
+}
+
+long random(long aMin, long aMax)
+{
+	return (aMin >= aMax) ? aMin : aMin + random(aMax - aMin);
+}
+
+HardwareSerial::HardwareSerial() :
+mEcho(false)
+{
+	//Handled by initializer list
+}
+
+void HardwareSerial::begin(unsigned long /*aBaud*/)
+{
+	//Do nothing
+}
+
+void HardwareSerial::flush()
+{
+	if(mEcho)
+	{
+		fflush(stdout);
+	}
+}
+
+void HardwareSerial::print(const char* apText)
+{
+	if(mEcho)
+	{
+		fputs(apText, stdout);
+	}
+}
+
+void HardwareSerial::print(const __FlashStringHelper* apText)
+{
+	print(reinterpret_cast<const char*>(apText));
+}
+
+void HardwareSerial::print(char aChar)
+{
+	if(mEcho)
+	{
+		putchar(aChar);
+	}
+}
+
+void HardwareSerial::print(int aValue)
+{
+	print((long)aValue);
+}
+
+void HardwareSerial::print(unsigned int aValue)
+{
+	print((unsigned long)aValue);
+}
+
+void HardwareSerial::print(long aValue)
+{
+	if(mEcho)
+	{
+		printf("%ld", aValue);
+	}
+}
+
+void HardwareSerial::print(unsigned long aValue)
+{
+	if(mEcho)
+	{
+		printf("%lu", aValue);
+	}
+}
+
+void HardwareSerial::println()
+{
+	print('\n');
+}
+
+void HardwareSerial::SetEcho(bool aEcho)
+{
+	mEcho = aEcho;
+}
+
+void Shim::Reset()
+{
+	sNowUs = 0;
+	gDelayCalls = 0;
+	gClockReads = 0;
+	memset(sPinLevels, LOW, sizeof(sPinLevels));
+	randomSeed(RANDOM_DEFAULT_SEED);
+}
+
+void Shim::Spend(unsigned long aUs)
+{
+	sNowUs += aUs;
+}
+
+unsigned long Shim::Now()
+{
+	return sNowUs;
+}
+
+void Shim::SetPin(uint8_t aPin, uint8_t aLevel)
+{
+	if(aPin < NUM_PINS)
+	{
+		sPinLevels[aPin] = aLevel;
+	}
+}
+
+uint8_t Shim::GetPin(uint8_t aPin)
+{
+	return (aPin < NUM_PINS) ? sPinLevels[aPin] : LOW;
+}
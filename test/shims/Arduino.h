@@ -0,0 +1,165 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Arduino.h
+ *   Host stand-in for the Arduino core used by the test harness. Time is
+ *   virtual: it only moves when the code under test spends it (delay(),
+ *   simulated I/O costs) or when the harness advances it.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <avr/pgmspace.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define NUM_PINS 32 //Pins the shim keeps levels for
+
+#define abs(x) ((x)>0?(x):-(x))
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(aString) (reinterpret_cast<const __FlashStringHelper*>(aString))
+
+//Virtual clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long aMs);
+void delayMicroseconds(unsigned int aUs);
+
+//Pins
+void pinMode(uint8_t aPin, uint8_t aMode);
+void digitalWrite(uint8_t aPin, uint8_t aLevel);
+int digitalRead(uint8_t aPin);
+void analogWrite(uint8_t aPin, int aValue);
+
+//Deterministic pseudo-random numbers
+void randomSeed(unsigned long aSeed);
+long random(long aMax);
+long random(long aMin, long aMax);
+
+/**
+ * Serial port stand-in. Output is discarded unless echo is turned on.
+ */
+class HardwareSerial
+{
+public:
+	HardwareSerial();
+
+	void begin(unsigned long aBaud);
+	void flush();
+
+	void print(const char* apText);
+	void print(const __FlashStringHelper* apText);
+	void print(char aChar);
+	void print(int aValue);
+	void print(unsigned int aValue);
+	void print(long aValue);
+	void print(unsigned long aValue);
+	void println();
+	template<class T> void println(T aValue)
+	{
+		print(aValue);
+		println();
+	}
+
+	/**
+	 * Echo everything printed to stdout?
+	 * Args:
+	 *   aEcho - TRUE to echo, FALSE to discard
+	 */
+	void SetEcho(bool aEcho);
+
+private:
+	bool mEcho;
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * Controls for the host shims, used by the harness only.
+ */
+namespace Shim
+{
+	/**
+	 * Put the clock, pins and random numbers back to power-on values.
+	 */
+	void Reset();
+
+	/**
+	 * Move the virtual clock forward, e.g. to model time spent on I/O.
+	 * Args:
+	 *   aUs - Microseconds to spend
+	 */
+	void Spend(unsigned long aUs);
+
+	/**
+	 * Read the virtual clock without spending any time on it.
+	 * Returns:
+	 *   Microseconds since Reset().
+	 */
+	unsigned long Now();
+
+	/**
+	 * Set the level an input pin reads back.
+	 * Args:
+	 *   aPin - Pin number (less than NUM_PINS)
+	 *   aLevel - HIGH or LOW
+	 */
+	void SetPin(uint8_t aPin, uint8_t aLevel);
+
+	/**
+	 * Get the last level written to or set on a pin.
+	 * Args:
+	 *   aPin - Pin number (less than NUM_PINS)
+	 * Returns:
+	 *   HIGH or LOW
+	 */
+	uint8_t GetPin(uint8_t aPin);
+
+	//Calls made since the last Reset(), for spotting waits and busy loops
+	extern unsigned long gDelayCalls;
+	extern unsigned long gClockReads;
+}
+
+#endif /* ARDUINO_H_ */
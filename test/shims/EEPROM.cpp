@@ -0,0 +1,65 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * EEPROM.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <EEPROM.h>
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass()
+{
+	Erase();
+}
+
+uint8_t EEPROMClass::read(int aAddress)
+{
+	return (aAddress >= 0 && aAddress < EEPROM_SIZE) ? mCells[aAddress] : 0xFF;
+}
+
+void EEPROMClass::write(int aAddress, uint8_t aValue)
+{
+	if(aAddress >= 0 && aAddress < EEPROM_SIZE)
+	{
+		Shim::Spend(EEPROM_WRITE_US);
+		mCells[aAddress] = aValue;
+		mWrites++;
+	}
+}
+
+void EEPROMClass::update(int aAddress, uint8_t aValue)
+{
+	if(read(aAddress) != aValue)
+	{
+		write(aAddress, aValue);
+	}
+}
+
+uint16_t EEPROMClass::length()
+{
+	return EEPROM_SIZE;
+}
+
+void EEPROMClass::Erase()
+{
+	memset(mCells, 0xFF, sizeof(mCells));
+	mWrites = 0;
+}
@@ -0,0 +1,77 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * EEPROM.h
+ *   Host stand-in for the Arduino EEPROM library. Cells that actually
+ *   change are charged the AVR erase/write time on the virtual clock.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <Arduino.h>
+
+#define EEPROM_SIZE 1024 //ATmega328
+#define EEPROM_WRITE_US 3400 //Erase and write of one cell
+
+class EEPROMClass
+{
+public:
+	EEPROMClass();
+
+	uint8_t read(int aAddress);
+	void write(int aAddress, uint8_t aValue);
+	void update(int aAddress, uint8_t aValue);
+	uint16_t length();
+
+	template<class T> T& get(int aAddress, T& arValue)
+	{
+		uint8_t* lpBytes = reinterpret_cast<uint8_t*>(&arValue);
+		for(size_t lIndex = 0; lIndex < sizeof(T); lIndex++)
+		{
+			lpBytes[lIndex] = read(aAddress + lIndex);
+		}
+		return arValue;
+	}
+
+	template<class T> const T& put(int aAddress, const T& arValue)
+	{
+		const uint8_t* lpBytes = reinterpret_cast<const uint8_t*>(&arValue);
+		for(size_t lIndex = 0; lIndex < sizeof(T); lIndex++)
+		{
+			update(aAddress + lIndex, lpBytes[lIndex]);
+		}
+		return arValue;
+	}
+
+	/**
+	 * Back to a blank part (all cells 0xFF).
+	 */
+	void Erase();
+
+	unsigned long mWrites; //Cells written since Erase()
+
+private:
+	uint8_t mCells[EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif /* EEPROM_H_ */
@@ -0,0 +1,209 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * USaber.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <USaber.h>
+
+DIYinoSoundPlayer::DIYinoSoundPlayer(int /*aTxPin*/, int /*aRxPin*/, DIYinoSoundMap* /*apSoundMap*/)
+{
+	Reset();
+}
+
+bool DIYinoSoundPlayer::Init()
+{
+	Send();
+	return true;
+}
+
+void DIYinoSoundPlayer::SetFont(uint8_t aFont)
+{
+	//Font only changes which folder the next sound comes from
+	mFont = aFont;
+}
+
+void DIYinoSoundPlayer::PlaySound(ESoundTypes aType, int /*aIndex*/)
+{
+	Send();
+	mPlayed[(int)aType]++;
+	mLastSound = aType;
+	mLastSoundTime = Shim::Now() / 1000;
+}
+
+void DIYinoSoundPlayer::PlayRandomSound(ESoundTypes aType)
+{
+	PlaySound(aType, 0);
+}
+
+void DIYinoSoundPlayer::SetVolume(uint8_t aVolume)
+{
+	Send();
+	mVolumeCommands++;
+	mVolume = aVolume;
+}
+
+void DIYinoSoundPlayer::Reset()
+{
+	mCommands = 0;
+	mVolumeCommands = 0;
+	memset(mPlayed, 0, sizeof(mPlayed));
+	mLastSound = ESoundTypes::eeNumSoundTypes;
+	mLastSoundTime = 0;
+	mVolume = 0;
+	mFont = 0;
+}
+
+void DIYinoSoundPlayer::Send()
+{
+	Shim::Spend(SOUND_COMMAND_US);
+	mCommands++;
+}
+
+RGBBlade::RGBBlade(int /*aPin1*/, int /*aPin2*/, int /*aPin3*/)
+{
+	Reset();
+}
+
+void RGBBlade::Init()
+{
+	Reset();
+}
+
+void RGBBlade::SetChannel(uint8_t aValue, int aChannel)
+{
+	if(aChannel >= 0 && aChannel < 3)
+	{
+		mChannels[aChannel] = aValue;
+	}
+}
+
+void RGBBlade::PerformIO()
+{
+	Shim::Spend(BLADE_IO_US);
+	memcpy(mShown, mChannels, sizeof(mShown));
+	mIOCount++;
+}
+
+bool RGBBlade::PowerUp(unsigned long aRampTime)
+{
+	bool lDone = false;
+
+	if(!mRamping)
+	{
+		mRamping = true;
+		mRampStart = Shim::Now() / 1000;
+	}
+
+	PerformIO();
+	if(Shim::Now() / 1000 - mRampStart >= aRampTime)
+	{
+		mRamping = false;
+		mLit = true;
+		lDone = true;
+	}
+
+	return lDone;
+}
+
+bool RGBBlade::PowerDown(unsigned long aRampTime)
+{
+	bool lDone = false;
+
+	if(!mRamping)
+	{
+		mRamping = true;
+		mRampStart = Shim::Now() / 1000;
+	}
+
+	Shim::Spend(BLADE_IO_US);
+	if(Shim::Now() / 1000 - mRampStart >= aRampTime)
+	{
+		mRamping = false;
+		mLit = false;
+		memset(mShown, 0, sizeof(mShown));
+		lDone = true;
+	}
+
+	return lDone;
+}
+
+void RGBBlade::ApplyFlicker(int /*aDepth*/)
+{
+	//Flicker only dims, leave the recorded color alone
+	Shim::Spend(BLADE_IO_US);
+}
+
+void RGBBlade::Reset()
+{
+	memset(mChannels, 0, sizeof(mChannels));
+	memset(mShown, 0, sizeof(mShown));
+	mIOCount = 0;
+	mLit = false;
+	mRamping = false;
+	mRampStart = 0;
+}
+
+bool RGBBlade::IsShowing(const uint8_t apColor[3])
+{
+	return (0 == memcmp(mShown, apColor, sizeof(mShown)));
+}
+
+Mpu6050LiteMotionManager::Mpu6050LiteMotionManager(MPU6050LiteTolData* /*apTolData*/)
+{
+	Reset();
+}
+
+void Mpu6050LiteMotionManager::Init()
+{
+	Shim::Spend(MOTION_UPDATE_US);
+}
+
+void Mpu6050LiteMotionManager::Update()
+{
+	Shim::Spend(MOTION_UPDATE_US);
+	mClash = mScriptClash;
+	mSwing = mScriptSwing;
+	mUpdates++;
+}
+
+bool Mpu6050LiteMotionManager::IsClash()
+{
+	return mClash;
+}
+
+bool Mpu6050LiteMotionManager::IsSwing()
+{
+	return (eeNone != mSwing);
+}
+
+ESwingMagnitude Mpu6050LiteMotionManager::GetSwingMagnitude()
+{
+	return mSwing;
+}
+
+void Mpu6050LiteMotionManager::Reset()
+{
+	mScriptClash = false;
+	mScriptSwing = eeNone;
+	mUpdates = 0;
+	mClash = false;
+	mSwing = eeNone;
+}
@@ -0,0 +1,224 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * USaber.h
+ *   Host fakes of the USaber library classes the saber uses. They record
+ *   what the state machine asks of them, charge the virtual clock for
+ *   the I/O the real parts do, and let the harness script the motion.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef USABER_H_
+#define USABER_H_
+
+#include <Arduino.h>
+
+//Virtual time charged for the I/O of each fake
+#define SOUND_COMMAND_US 10400 //10-byte command frame at 9600 baud
+#define MOTION_UPDATE_US 1530 //Register select and 14-byte read at 100kHz
+#define BLADE_IO_US 20 //Three PWM compare registers
+
+enum class ESoundTypes
+{
+	eeFontIdSnd,
+	eeBootSnd,
+	eePowerUpSnd,
+	eePowerDownSnd,
+	eeHumSnd,
+	eeSwingSnd,
+	eeClashSnd,
+	eeLockupSnd,
+	eeBlasterSnd,
+	eeForceSnd,
+	eeCustomSnd,
+	eeMenuSnd,
+	eeNumSoundTypes
+};
+
+enum ESwingMagnitude
+{
+	eeNone,
+	eeSmall,
+	eeMedium,
+	eeLarge
+};
+
+struct WT588DSoundMap
+{
+	struct
+	{
+		int FontIdsPerFont;
+		int HumSoundsPerFont;
+		int PowerUpSoundsPerFont;
+		int PowerDownSoundsPerFont;
+		int ClashSoundsPerFont;
+		int SwingSoundsPerFont;
+		int LockupSoundsPerFont;
+		int BlasterSoundsPerFont;
+		int ForceSoundsPerFont;
+		int CustomSoundsPerFont;
+		int MenuSounds;
+	} Features;
+
+	struct
+	{
+		int BaseAddr;
+		int BlasterBase;
+		int BootBase;
+		int ClashBase;
+		int SwingBase;
+		int LockupBase;
+		int PowerupBase;
+		int PowerdownBase;
+		int HumBase;
+		int FontIdBase;
+		int CustomBase;
+		int MenuBase;
+	} Locations;
+};
+
+typedef WT588DSoundMap DIYinoSoundMap;
+
+struct MPU6050LiteTolData
+{
+	int mSwingLarge;
+	int mSwingMedium;
+	int mSwingSmall;
+	int mClash;
+	int mTwist;
+};
+
+/**
+ * Sound player fake. Records the commands sent to the sound module.
+ */
+class DIYinoSoundPlayer
+{
+public:
+	DIYinoSoundPlayer(int aTxPin, int aRxPin, DIYinoSoundMap* apSoundMap);
+
+	bool Init();
+	void SetFont(uint8_t aFont);
+	void PlaySound(ESoundTypes aType, int aIndex);
+	void PlayRandomSound(ESoundTypes aType);
+	void SetVolume(uint8_t aVolume);
+
+	/**
+	 * Forget the recorded commands.
+	 */
+	void Reset();
+
+	unsigned long mCommands; //Commands sent to the module
+	unsigned long mVolumeCommands; //Of those, volume changes
+	unsigned long mPlayed[(int)ESoundTypes::eeNumSoundTypes]; //Sounds started, by type
+	ESoundTypes mLastSound; //Most recent sound started
+	unsigned long mLastSoundTime; //When it was started (ms)
+	uint8_t mVolume; //Last volume sent
+	uint8_t mFont; //Last font selected
+
+private:
+	/**
+	 * Charge one command to the clock.
+	 */
+	void Send();
+};
+
+/**
+ * Blade interface, as in USaber.
+ */
+class IBladeManager
+{
+public:
+	virtual ~IBladeManager() {}
+	virtual void Init() = 0;
+	virtual void SetChannel(uint8_t aValue, int aChannel) = 0;
+	virtual void PerformIO() = 0;
+	virtual bool PowerUp(unsigned long aRampTime) = 0;
+	virtual bool PowerDown(unsigned long aRampTime) = 0;
+	virtual void ApplyFlicker(int aDepth) = 0;
+};
+
+/**
+ * Blade fake. Ramps are timed against the virtual clock and every color
+ * pushed to the LEDs is recorded.
+ */
+class RGBBlade : public IBladeManager
+{
+public:
+	RGBBlade(int aPin1, int aPin2, int aPin3);
+
+	void Init();
+	void SetChannel(uint8_t aValue, int aChannel);
+	void PerformIO();
+	bool PowerUp(unsigned long aRampTime);
+	bool PowerDown(unsigned long aRampTime);
+	void ApplyFlicker(int aDepth);
+
+	/**
+	 * Blade off, no colors shown.
+	 */
+	void Reset();
+
+	/**
+	 * Is the given color on the LEDs right now?
+	 * Args:
+	 *   apColor - Channel values 0, 1, 2
+	 * Returns:
+	 *   TRUE if the LEDs show that color, FALSE otherwise.
+	 */
+	bool IsShowing(const uint8_t apColor[3]);
+
+	uint8_t mChannels[3]; //Values set, not necessarily shown yet
+	uint8_t mShown[3]; //Values on the LEDs after the last PerformIO()
+	unsigned long mIOCount; //PerformIO() calls
+	bool mLit; //Blade is on (ramped up and not ramped down)
+
+private:
+	bool mRamping; //A ramp is in progress
+	unsigned long mRampStart; //When it started (ms)
+};
+
+/**
+ * Motion manager fake. The harness scripts what the next Update() sees.
+ */
+class Mpu6050LiteMotionManager
+{
+public:
+	Mpu6050LiteMotionManager(MPU6050LiteTolData* apTolData);
+
+	void Init();
+	void Update();
+	bool IsClash();
+	bool IsSwing();
+	ESwingMagnitude GetSwingMagnitude();
+
+	/**
+	 * No motion.
+	 */
+	void Reset();
+
+	bool mScriptClash; //Report a clash from the next Update() on
+	ESwingMagnitude mScriptSwing; //Report this swing from the next Update() on
+	unsigned long mUpdates; //Update() calls
+
+private:
+	bool mClash; //Latched by Update()
+	ESwingMagnitude mSwing;
+};
+
+#endif /* USABER_H_ */
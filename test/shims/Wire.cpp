@@ -0,0 +1,204 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Wire.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <Wire.h>
+
+//Time to move one byte (plus ack) over a 100kHz bus
+#define WIRE_BYTE_US 90
+
+#define MPU6050_RA_XG_OFFS_USRH 0x13
+#define MPU6050_RA_GYRO_CONFIG 0x1B
+#define MPU6050_RA_GYRO_XOUT_H 0x43
+#define MPU6050_RA_GYRO_ZOUT_L 0x48
+
+TwoWire Wire;
+
+FakeMpu6050::FakeMpu6050()
+{
+	Reset();
+}
+
+void FakeMpu6050::Reset()
+{
+	memset(mRegisters, 0, sizeof(mRegisters));
+	memset(mLatched, 0, sizeof(mLatched));
+	mPresent = true;
+	mNoise = 0;
+	mNoiseState = 1;
+	for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+	{
+		mBias[lAxis] = 0;
+		mRate[lAxis] = 0;
+		mDrift[lAxis] = 0;
+	}
+}
+
+uint8_t FakeMpu6050::ReadRegister(uint8_t aRegister)
+{
+	uint8_t lValue = 0;
+
+	if(aRegister >= MPU6050_RA_GYRO_XOUT_H && aRegister <= MPU6050_RA_GYRO_ZOUT_L)
+	{
+		//Sample all axes together, like the sensor's output registers
+		if(MPU6050_RA_GYRO_XOUT_H == aRegister)
+		{
+			for(uint8_t lAxis = 0; lAxis < 3; lAxis++)
+			{
+				mLatched[lAxis] = GyroOutput(lAxis);
+			}
+		}
+
+		uint8_t lIndex = aRegister - MPU6050_RA_GYRO_XOUT_H;
+		uint16_t lOutput = (uint16_t)mLatched[lIndex / 2];
+		lValue = (0 == (lIndex & 1)) ? (lOutput >> 8) : (lOutput & 0xFF);
+	}
+	else if(aRegister < MPU6050_REGISTERS)
+	{
+		lValue = mRegisters[aRegister];
+	}
+
+	return lValue;
+}
+
+void FakeMpu6050::WriteRegister(uint8_t aRegister, uint8_t aValue)
+{
+	if(aRegister < MPU6050_REGISTERS)
+	{
+		mRegisters[aRegister] = aValue;
+	}
+}
+
+int16_t FakeMpu6050::GetOffset(uint8_t aAxis)
+{
+	uint8_t lRegister = MPU6050_RA_XG_OFFS_USRH + aAxis * 2;
+	return (int16_t)((mRegisters[lRegister] << 8) | mRegisters[lRegister + 1]);
+}
+
+int16_t FakeMpu6050::GyroOutput(uint8_t aAxis)
+{
+	uint8_t lFullScale = (mRegisters[MPU6050_RA_GYRO_CONFIG] >> 3) & 0x03;
+	float lLsbPerDps = 131.0f / (1 << lFullScale);
+
+	//Uniform noise in [-mNoise, mNoise]
+	mNoiseState = mNoiseState * 1103515245UL + 12345UL;
+	float lNoise = mNoise * ((float)((mNoiseState >> 16) & 0x7FFF) / 16383.5f - 1.0f);
+
+	float lSeconds = Shim::Now() / 1000000.0f;
+	float lDps = mRate[aAxis] + mBias[aAxis] + mDrift[aAxis] * lSeconds + lNoise;
+
+	//Offsets are in 1000 deg/s range units (4 LSB at 250 deg/s)
+	long lRaw = (long)(lDps * lLsbPerDps) + (GetOffset(aAxis) * 4L) / (1 << lFullScale);
+
+	return (int16_t)constrain(lRaw, -32768L, 32767L);
+}
+
+TwoWire::TwoWire() :
+mAddress(0),
+mTxCount(0),
+mPointer(0),
+mRxCount(0),
+mRxIndex(0)
+{
+	//Handled by initializer list
+}
+
+void TwoWire::begin()
+{
+	//Do nothing
+}
+
+void TwoWire::setClock(unsigned long /*aClock*/)
+{
+	//Do nothing
+}
+
+void TwoWire::beginTransmission(uint8_t aAddress)
+{
+	mAddress = aAddress;
+	mTxCount = 0;
+}
+
+size_t TwoWire::write(uint8_t aValue)
+{
+	size_t lWritten = 0;
+
+	if(mTxCount < WIRE_BUFFER_SIZE)
+	{
+		mTxBuffer[mTxCount++] = aValue;
+		lWritten = 1;
+	}
+
+	return lWritten;
+}
+
+uint8_t TwoWire::endTransmission(bool /*aStop*/)
+{
+	uint8_t lStatus = 2; //Address not acknowledged
+
+	Shim::Spend((1 + mTxCount) * WIRE_BYTE_US);
+
+	if(MPU6050_BUS_ADDRESS == mAddress && mMpu.mPresent)
+	{
+		//First byte sets the register pointer, the rest are written from there
+		if(mTxCount > 0)
+		{
+			mPointer = mTxBuffer[0];
+			for(uint8_t lIndex = 1; lIndex < mTxCount; lIndex++)
+			{
+				mMpu.WriteRegister(mPointer++, mTxBuffer[lIndex]);
+			}
+		}
+		lStatus = 0;
+	}
+	mTxCount = 0;
+
+	return lStatus;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t aAddress, uint8_t aQuantity)
+{
+	mRxCount = 0;
+	mRxIndex = 0;
+
+	Shim::Spend((1 + aQuantity) * WIRE_BYTE_US);
+
+	if(MPU6050_BUS_ADDRESS == aAddress && mMpu.mPresent)
+	{
+		while(mRxCount < aQuantity && mRxCount < WIRE_BUFFER_SIZE)
+		{
+			mRxBuffer[mRxCount++] = mMpu.ReadRegister(mPointer++);
+		}
+	}
+
+	return mRxCount;
+}
+
+int TwoWire::available()
+{
+	return mRxCount - mRxIndex;
+}
+
+int TwoWire::read()
+{
+	return (mRxIndex < mRxCount) ? mRxBuffer[mRxIndex++] : -1;
+}
@@ -0,0 +1,128 @@
+/*
+ This file is part of the FX-Saber Operating System (FX-SaberOS).
+
+ FX-SaberOS is free software: you can redistribute it
+ and/or modify it under the terms of the GNU General Public License as
+ published by the Free Software Foundation, either version 3 of the License,
+ or (at your option) any later version.
+
+ The FX-SaberOS software is distributed in the hope that it will be
+ useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with the FX-SaberOS software.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Wire.h
+ *   Host stand-in for the Arduino I2C library. The only device on the bus
+ *   is a simulated MPU6050 whose gyro bias, rates and noise the harness
+ *   controls. Bus traffic is charged to the virtual clock.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef WIRE_H_
+#define WIRE_H_
+
+#include <Arduino.h>
+
+#define MPU6050_BUS_ADDRESS 0x68
+#define MPU6050_REGISTERS 128
+#define WIRE_BUFFER_SIZE 32
+
+/**
+ * Register-level model of the MPU6050 gyro. The gyro output is the true
+ * rate plus bias and noise, corrected by the user offset registers, at
+ * the full-scale range selected in GYRO_CONFIG.
+ */
+class FakeMpu6050
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	FakeMpu6050();
+
+	/**
+	 * Back to power-on register values, no bias, no motion, no noise.
+	 */
+	void Reset();
+
+	/**
+	 * Read a register, computing gyro outputs on demand.
+	 * Args:
+	 *   aRegister - Register address
+	 * Returns:
+	 *   Register value
+	 */
+	uint8_t ReadRegister(uint8_t aRegister);
+
+	/**
+	 * Write a register.
+	 * Args:
+	 *   aRegister - Register address
+	 *   aValue - New value
+	 */
+	void WriteRegister(uint8_t aRegister, uint8_t aValue);
+
+	/**
+	 * Get the user offset of one axis.
+	 * Args:
+	 *   aAxis - 0, 1 or 2 for X, Y or Z
+	 * Returns:
+	 *   Offset register value
+	 */
+	int16_t GetOffset(uint8_t aAxis);
+
+	bool mPresent; //Does the sensor acknowledge its address?
+	float mBias[3]; //Zero-rate bias (deg/s)
+	float mRate[3]; //True angular rate (deg/s)
+	float mNoise; //Peak uniform noise (deg/s)
+	float mDrift[3]; //Bias change per second of virtual time (deg/s)
+
+private:
+	/**
+	 * Current output of one gyro axis in LSB.
+	 */
+	int16_t GyroOutput(uint8_t aAxis);
+
+	uint8_t mRegisters[MPU6050_REGISTERS];
+	int16_t mLatched[3]; //Gyro outputs latched when the X high byte is read
+	unsigned long mNoiseState; //Noise generator, separate from random()
+};
+
+/**
+ * I2C master stand-in with the Arduino TwoWire interface.
+ */
+class TwoWire
+{
+public:
+	TwoWire();
+
+	void begin();
+	void setClock(unsigned long aClock);
+	void beginTransmission(uint8_t aAddress);
+	size_t write(uint8_t aValue);
+	uint8_t endTransmission(bool aStop = true);
+	uint8_t requestFrom(uint8_t aAddress, uint8_t aQuantity);
+	int available();
+	int read();
+
+	FakeMpu6050 mMpu; //The device on the bus
+
+private:
+	uint8_t mAddress; //Address of the transmission being built
+	uint8_t mTxBuffer[WIRE_BUFFER_SIZE];
+	uint8_t mTxCount;
+	uint8_t mPointer; //Register pointer of the MPU6050
+	uint8_t mRxBuffer[WIRE_BUFFER_SIZE];
+	uint8_t mRxCount;
+	uint8_t mRxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif /* WIRE_H_ */